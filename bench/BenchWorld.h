@@ -0,0 +1,93 @@
+#pragma once
+#include "MockWorld.h"
+#include "PinCapture.h"
+#include <charconv>
+#include <format>
+#include <random>
+#include <vector>
+
+// Heap allocations made by the calling thread so far, see HeapCounter.cpp.
+auto HeapAllocations() -> uint64_t;
+
+// Host with the same per-call cost profile as the mod: pin names are only resolved for new pins, entity names every call.
+class MockCaptureHost : public IPinCaptureHost {
+public:
+	auto GetPinName(uint32 pinId) -> Symbol override {
+		return Intern(std::format("Pin{}", pinId));
+	}
+
+	auto GetEntityName(ZEntityRef) -> Symbol override {
+		return Intern("MockEntity");
+	}
+
+	auto GetPinId(std::string_view name) -> std::optional<uint32> override {
+		uint32 pinId = 0;
+		if (!name.starts_with("Pin") || std::from_chars(name.data() + 3, name.data() + name.size(), pinId).ec != std::errc())
+			return std::nullopt;
+		return pinId;
+	}
+};
+
+// Fixed scene shared by the benchmarks so results stay comparable between runs and commits.
+struct BenchScene {
+	static constexpr uint32 Seed = 1234;
+	static constexpr size_t EntityTypeCount = 16;
+	static constexpr size_t EntityCount = 1024;
+	static constexpr size_t CallCount = 4096;
+
+	struct Call {
+		ZEntityRef entity;
+		uint32 pinId;
+	};
+
+	MockWorld world;
+	ZScene scene;
+	STypeID* floatType;
+	STypeID* vectorType;
+	STypeID* stringType;
+	std::vector<ZEntityType*> entityTypes;
+	std::vector<ZEntityRef> entities;
+	// Pre-generated so the benchmarks don't measure the random number generator.
+	std::vector<Call> calls;
+	float payload = 1.5f;
+
+	explicit BenchScene(size_t pinCount = 256) {
+		floatType = world.Type<float32>("float32");
+		vectorType = world.Type<SVector3>("SVector3");
+		stringType = world.Type<ZString>("ZString");
+
+		const MockProperty s_Props[] = {
+			{ "m_bEnabled", world.Type<bool>("bool") },
+			{ "m_fValue", floatType },
+			{ "m_vPosition", vectorType },
+			{ "m_sName", stringType },
+		};
+
+		for (size_t i = 0; i < EntityTypeCount; ++i)
+			entityTypes.push_back(world.EntityType(InterfaceName(i), s_Props));
+
+		std::mt19937 rng(Seed);
+
+		// Roots first, then children of earlier entities, so ancestries are a few levels deep.
+		for (size_t i = 0; i < EntityCount; ++i) {
+			const auto type = entityTypes[rng() % entityTypes.size()];
+			const auto parent = i < 16 ? ZEntityRef() : entities[rng() % i];
+			entities.push_back(world.Entity(type, parent));
+		}
+
+		calls.reserve(CallCount);
+
+		for (size_t i = 0; i < CallCount; ++i)
+			calls.push_back({ entities[rng() % entities.size()], static_cast<uint32>(0x10000 + rng() % pinCount) });
+	}
+
+	static auto InterfaceName(size_t index) -> const char* {
+		static const char* s_Names[] = {
+			"ZSpatialEntity", "ZTimerEntity", "ZBoolEntity", "ZFloatEntity",
+			"ZValueEntity", "ZEventEntity", "ZCompositeEntity", "ZActorEntity",
+			"ZItemEntity", "ZDoorEntity", "ZLightEntity", "ZSoundEntity",
+			"ZTriggerEntity", "ZCameraEntity", "ZOutfitEntity", "ZKeywordEntity",
+		};
+		return s_Names[index % std::size(s_Names)];
+	}
+};
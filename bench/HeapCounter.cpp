@@ -0,0 +1,54 @@
+#include "BenchWorld.h"
+#include <cstdlib>
+#include <new>
+
+// Replaces the global allocation functions to count heap allocations made by the benchmark thread.
+static thread_local uint64_t s_HeapAllocations = 0;
+
+auto HeapAllocations() -> uint64_t {
+	return s_HeapAllocations;
+}
+
+static auto AllocateAligned(size_t size, size_t alignment) -> void* {
+	++s_HeapAllocations;
+	size = (std::max<size_t>(size, 1) + alignment - 1) & ~(alignment - 1);
+#ifdef _WIN32
+	auto block = _aligned_malloc(size, alignment);
+#else
+	auto block = std::aligned_alloc(alignment, size);
+#endif
+	if (!block) throw std::bad_alloc();
+	return block;
+}
+
+static auto FreeAligned(void* block) -> void {
+#ifdef _WIN32
+	_aligned_free(block);
+#else
+	std::free(block);
+#endif
+}
+
+void* operator new(size_t size) {
+	return AllocateAligned(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void* operator new(size_t size, std::align_val_t alignment) {
+	return AllocateAligned(size, std::max<size_t>(static_cast<size_t>(alignment), __STDCPP_DEFAULT_NEW_ALIGNMENT__));
+}
+
+void operator delete(void* block) noexcept {
+	FreeAligned(block);
+}
+
+void operator delete(void* block, size_t) noexcept {
+	FreeAligned(block);
+}
+
+void operator delete(void* block, std::align_val_t) noexcept {
+	FreeAligned(block);
+}
+
+void operator delete(void* block, size_t, std::align_val_t) noexcept {
+	FreeAligned(block);
+}
@@ -0,0 +1,212 @@
+#include "BenchWorld.h"
+#include "CallJson.h"
+#include "Functions.h"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <deque>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Payload passed as a dynamic object, pointing at a value owned by the builder.
+class MockDynamicObject : public ZDynamicObject {
+public:
+	MockDynamicObject(STypeID* type, void* data) {
+		m_pTypeID = type;
+		m_pData = data;
+	}
+};
+
+// Dynamic objects laid out the way the game builds them, registered so Is<T>() resolves their types.
+class DynamicObjectBuilder {
+public:
+	DynamicObjectBuilder() {
+		MockTypeId<TArray<SDynamicObjectKeyValuePair>> = world.Type<TArray<SDynamicObjectKeyValuePair>>("TArray<SDynamicObjectKeyValuePair>", TIF_Container);
+		MockTypeId<ZString> = world.Type<ZString>("ZString");
+		MockTypeId<SVector3> = world.Type<SVector3>("SVector3");
+		otherType = world.Type<float32>("float32");
+	}
+
+	~DynamicObjectBuilder() {
+		MockTypeId<TArray<SDynamicObjectKeyValuePair>> = nullptr;
+		MockTypeId<ZString> = nullptr;
+		MockTypeId<SVector3> = nullptr;
+	}
+
+	auto String(std::string str) -> ZDynamicObject {
+		auto& chars = strings.emplace_back(std::move(str));
+		return MockDynamicObject(MockTypeId<ZString>, &zstrings.emplace_back(chars));
+	}
+
+	auto Vector(SVector3 value) -> ZDynamicObject {
+		return MockDynamicObject(MockTypeId<SVector3>, &vectors.emplace_back(value));
+	}
+
+	// Written by the game's ZDynamicObject_ToString.
+	auto Other() -> ZDynamicObject {
+		return MockDynamicObject(otherType, &otherValue);
+	}
+
+	auto Object(std::vector<SDynamicObjectKeyValuePair> entries) -> ZDynamicObject {
+		auto& storage = entryLists.emplace_back(std::move(entries));
+		auto& array = arrays.emplace_back();
+		array.m_pBegin = storage.data();
+		array.m_pEnd = array.m_pAllocationEnd = storage.data() + storage.size();
+		return MockDynamicObject(MockTypeId<TArray<SDynamicObjectKeyValuePair>>, &array);
+	}
+
+	auto Key(std::string key) -> ZString {
+		return ZString(strings.emplace_back(std::move(key)));
+	}
+
+	// `depth` objects nested in each other, each with a few values next to the child.
+	auto Deep(size_t depth) -> ZDynamicObject {
+		auto obj = this->Object({ { this->Key("name"), this->String("leaf") } });
+
+		for (size_t i = 0; i < depth; ++i) {
+			obj = this->Object({
+				{ this->Key("name"), this->String("Level " + std::to_string(i)) },
+				{ this->Key("position"), this->Vector({ 1.5f * i, -2.25f, 1000.f / (i + 1) }) },
+				{ this->Key("tags"), this->String("\"quoted\" and\ttabbed") },
+				{ this->Key("child"), obj },
+			});
+		}
+
+		return obj;
+	}
+
+	// One object with `width` values of mixed types, most of them strings like in the game's event payloads.
+	auto Wide(size_t width) -> ZDynamicObject {
+		std::vector<SDynamicObjectKeyValuePair> entries;
+
+		for (size_t i = 0; i < width; ++i) {
+			auto key = this->Key("m_Value" + std::to_string(i));
+
+			switch (i % 4) {
+			case 0: entries.push_back({ key, this->Vector({ 0.1f * i, 2.f, -3.5f }) }); break;
+			case 1: entries.push_back({ key, this->Other() }); break;
+			default: entries.push_back({ key, this->String("Assembly:/_pro/characters/npc_" + std::to_string(i) + ".template") }); break;
+			}
+		}
+
+		return this->Object(std::move(entries));
+	}
+
+private:
+	MockWorld world;
+	STypeID* otherType;
+	float32 otherValue = 1.f;
+	std::deque<std::string> strings;
+	std::deque<ZString> zstrings;
+	std::deque<SVector3> vectors;
+	std::deque<std::vector<SDynamicObjectKeyValuePair>> entryLists;
+	std::deque<TArray<SDynamicObjectKeyValuePair>> arrays;
+};
+
+// The ostringstream based serializer the writer replaced, kept as the baseline.
+static auto LegacyDynamicObjectToString(ZDynamicObject& obj) -> std::string {
+	if (obj.Is<TArray<SDynamicObjectKeyValuePair>>()) {
+		auto arr = obj.As<TArray<SDynamicObjectKeyValuePair>>();
+		auto first = true;
+		auto str = std::ostringstream();
+		str << "{";
+
+		for (auto& entry : *arr) {
+			if (!first) str << ",";
+			first = false;
+
+			auto objStr = LegacyDynamicObjectToString(entry.value);
+			str << std::quoted(entry.sKey.c_str()) << ":" << objStr.c_str();
+		}
+
+		str << "}";
+		return str.str();
+	}
+
+	if (obj.Is<ZString>()) {
+		auto res = obj.As<ZString>();
+		auto resSV = std::string_view(res->c_str(), res->size());
+		auto fixedStr = std::string(resSV.size(), '\0');
+		std::remove_copy(resSV.cbegin(), resSV.cend(), fixedStr.begin(), '\n');
+		return (std::ostringstream() << std::quoted(fixedStr.c_str())).str();
+	}
+
+	if (obj.Is<SVector3>()) {
+		auto res = obj.As<SVector3>();
+		return (std::ostringstream() << std::quoted(std::to_string(res->x) + "," + std::to_string(res->y) + "," + std::to_string(res->z))).str();
+	}
+
+	ZString res;
+	Functions::ZDynamicObject_ToString->Call(const_cast<ZDynamicObject*>(&obj), &res);
+	return std::string{res.ToStringView()};
+}
+
+static void BM_DynamicObjectJson(benchmark::State& state, bool legacy, bool deep) {
+	DynamicObjectBuilder s_Builder;
+	auto s_Object = deep ? s_Builder.Deep(static_cast<size_t>(state.range(0))) : s_Builder.Wide(static_cast<size_t>(state.range(0)));
+	size_t s_Bytes = 0;
+
+	for (auto _ : state) {
+		if (legacy) {
+			auto json = LegacyDynamicObjectToString(s_Object);
+			s_Bytes += json.size();
+			benchmark::DoNotOptimize(json.data());
+		}
+		else {
+			auto prop = Properties::ZDynamicObjectProperty(nullptr, &s_Object);
+			auto& json = prop.Get<PropertyInfo_Json>()->value;
+			s_Bytes += json.size();
+			benchmark::DoNotOptimize(json.data());
+		}
+	}
+
+	state.SetBytesProcessed(static_cast<int64_t>(s_Bytes));
+}
+BENCHMARK_CAPTURE(BM_DynamicObjectJson, legacy_deep, true, true)->Arg(8)->Arg(30);
+BENCHMARK_CAPTURE(BM_DynamicObjectJson, writer_deep, false, true)->Arg(8)->Arg(30);
+BENCHMARK_CAPTURE(BM_DynamicObjectJson, legacy_wide, true, false)->Arg(16)->Arg(256);
+BENCHMARK_CAPTURE(BM_DynamicObjectJson, writer_wide, false, false)->Arg(16)->Arg(256);
+
+// Serializing captured calls with their tree and properties, one NDJSON line each as the export does.
+static void BM_CallJson(benchmark::State& state) {
+	BenchScene s_Scene;
+	MockCaptureHost s_Host;
+	PinCapture s_Capture(s_Host);
+	s_Capture.SetRateLimit(false, 15.f, 0);
+
+	// Calls queued before the capture has seen the scene are dropped as belonging to the previous one.
+	s_Capture.Update(&s_Scene.scene);
+
+	for (auto& call : s_Scene.calls)
+		s_Capture.OnPinOutput(call.entity, call.pinId, MockObjectRef(s_Scene.floatType, &s_Scene.payload));
+
+	s_Capture.Update(&s_Scene.scene);
+	s_Capture.PublishSnapshot();
+	const auto s_Snapshot = s_Capture.GetSnapshot();
+
+	// Properties are decoded once up front, the way the UI usually already has by the time of an export.
+	std::vector<std::pair<const PinView*, const PinCallData*>> s_Calls;
+	for (auto& pin : s_Snapshot->pins) {
+		for (auto& call : pin->calls) {
+			s_Calls.emplace_back(pin.get(), call.get());
+			if (call->props) call->props->Materialize();
+		}
+	}
+
+	JsonWriter s_Writer;
+	size_t s_Bytes = 0;
+	size_t next = 0;
+
+	for (auto _ : state) {
+		s_Writer.Clear();
+		WriteCallJson(s_Writer, *s_Calls[next].first, *s_Calls[next].second);
+		s_Bytes += s_Writer.Size();
+		benchmark::DoNotOptimize(s_Writer.View().data());
+		if (++next == s_Calls.size()) next = 0;
+	}
+
+	state.SetItemsProcessed(state.iterations());
+	state.SetBytesProcessed(static_cast<int64_t>(s_Bytes));
+}
+BENCHMARK(BM_CallJson);
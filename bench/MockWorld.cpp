@@ -0,0 +1,93 @@
+#include "MockWorld.h"
+#include <algorithm>
+
+// Entities start with their type and logical parent, see ZEntityImpl in the mock ZEntity.h.
+static constexpr size_t EntityHeaderSize = 2 * sizeof(void*);
+
+MockWorld::~MockWorld() {
+	for (auto& entity : entities) {
+		for (auto& prop : entity.typeData->properties)
+			prop.m_pType->getPropertyInfo()->m_pType->typeInfo()->m_pTypeFunctions->destruct(entity.memory + prop.m_nOffset);
+
+		::operator delete(entity.memory, std::align_val_t(alignof(std::max_align_t)));
+	}
+}
+
+auto MockWorld::EnumType(const char* name, std::span<const IEnumType::SEnumItem> items) -> STypeID* {
+	auto type = this->Type<int32>(name, TIF_Enum);
+
+	// Enum types need the extra entries, so the plain type info is swapped for an IEnumType.
+	auto& info = enumInfos.emplace_back(std::make_unique<IEnumType>());
+	static_cast<IType&>(*info) = *type->pTypeInfo;
+
+	auto& entries = enumItems.emplace_back(items.begin(), items.end());
+	info->m_entries.m_pBegin = entries.data();
+	info->m_entries.m_pEnd = info->m_entries.m_pAllocationEnd = entries.data() + entries.size();
+
+	type->pTypeInfo = info.get();
+	return type;
+}
+
+auto MockWorld::EntityType(const char* interfaceName, std::span<const MockProperty> props) -> ZEntityType* {
+	auto& data = entityTypes.emplace_back();
+	data.properties.resize(props.size());
+	data.propertyTypes.resize(props.size());
+	data.classProperties.resize(props.size());
+
+	auto offset = EntityHeaderSize;
+
+	for (size_t i = 0; i < props.size(); ++i) {
+		const auto s_TypeInfo = props[i].type->typeInfo();
+		const auto s_PropertyId = static_cast<uint32>(0x1000 + i);
+
+		offset = (offset + s_TypeInfo->m_nTypeAlignment - 1) & ~size_t(s_TypeInfo->m_nTypeAlignment - 1);
+
+		auto& classProperty = data.classProperties[i];
+		classProperty.m_pName = props[i].name;
+		classProperty.m_nPropertyID = s_PropertyId;
+		classProperty.m_pType = props[i].type;
+		classProperty.m_nOffset = static_cast<int64>(offset);
+
+		data.propertyTypes[i].m_pPropertyInfo = &classProperty;
+
+		auto& property = data.properties[i];
+		property.m_nPropertyId = s_PropertyId;
+		property.m_nOffset = offset;
+		property.m_pType = &data.propertyTypes[i];
+
+		offset += s_TypeInfo->m_nTypeSize;
+	}
+
+	data.size = offset;
+	data.propertyArray.m_pBegin = data.properties.data();
+	data.propertyArray.m_pEnd = data.propertyArray.m_pAllocationEnd = data.properties.data() + data.properties.size();
+
+	data.entityInterface.m_pTypeId = this->Type<std::byte>(interfaceName, TIF_Entity | TIF_Class);
+	data.interfaceArray.m_pBegin = &data.entityInterface;
+	data.interfaceArray.m_pEnd = data.interfaceArray.m_pAllocationEnd = &data.entityInterface + 1;
+
+	data.type.m_pProperties01 = &data.propertyArray;
+	data.type.m_pInterfaces = &data.interfaceArray;
+	return &data.type;
+}
+
+auto MockWorld::Entity(ZEntityType* entityType, ZEntityRef parent) -> ZEntityRef {
+	const auto s_TypeData = std::find_if(entityTypes.begin(), entityTypes.end(), [&](const EntityTypeData& data) {
+		return &data.type == entityType;
+	});
+
+	auto& entity = entities.emplace_back();
+	entity.typeData = &*s_TypeData;
+	entity.type = *entityType;
+	entity.type.m_nEntityId = nextEntityId++;
+	entity.memory = static_cast<std::byte*>(::operator new(s_TypeData->size, std::align_val_t(alignof(std::max_align_t))));
+
+	auto header = reinterpret_cast<void**>(entity.memory);
+	header[0] = &entity.type;
+	header[1] = parent.m_pEntity;
+
+	for (auto& prop : s_TypeData->properties)
+		prop.m_pType->getPropertyInfo()->m_pType->typeInfo()->m_pTypeFunctions->construct(entity.memory + prop.m_nOffset);
+
+	return ZEntityRef(reinterpret_cast<ZEntityType**>(entity.memory));
+}
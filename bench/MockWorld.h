@@ -0,0 +1,87 @@
+#pragma once
+#include "PinCapture.h"
+#include <Glacier/IEnumType.h>
+#include <deque>
+#include <memory>
+#include <new>
+#include <span>
+#include <string>
+#include <vector>
+
+struct MockProperty {
+	const char* name;
+	STypeID* type;
+};
+
+// Payload passed to the hook, pointing at a value owned by the caller.
+class MockObjectRef : public ZObjectRef {
+public:
+	MockObjectRef(STypeID* type, void* data) {
+		m_pTypeID = type;
+		m_pData = data;
+	}
+};
+
+// Owns mock types and entities, laid out in memory the way the capture code reads the game's.
+class MockWorld {
+public:
+	MockWorld() = default;
+	MockWorld(const MockWorld&) = delete;
+	MockWorld& operator=(const MockWorld&) = delete;
+	~MockWorld();
+
+	template <typename T>
+	auto Type(const char* name, uint16 flags = TIF_Primitive) -> STypeID* {
+		static constexpr STypeFunctions s_Functions = {
+			[](void* p) { new (p) T(); },
+			[](void* p, const void* other) { new (p) T(*static_cast<const T*>(other)); },
+			[](void* p) { static_cast<T*>(p)->~T(); },
+			[](void* p, void* other) { *static_cast<T*>(p) = *static_cast<T*>(other); },
+			nullptr,
+			nullptr,
+		};
+
+		auto& info = typeInfos.emplace_back(std::make_unique<IType>());
+		info->m_pTypeFunctions = const_cast<STypeFunctions*>(&s_Functions);
+		info->m_nTypeSize = sizeof(T);
+		info->m_nTypeAlignment = alignof(T);
+		info->m_nTypeInfoFlags = flags;
+		info->m_pTypeName = name;
+
+		auto& type = types.emplace_back();
+		type.pTypeInfo = info.get();
+		return &type;
+	}
+
+	auto EnumType(const char* name, std::span<const IEnumType::SEnumItem> items) -> STypeID*;
+
+	// An entity type with the given interface and properties. Every entity created from it gets its own copy with a new ID.
+	auto EntityType(const char* interfaceName, std::span<const MockProperty> props) -> ZEntityType*;
+	auto Entity(ZEntityType* entityType, ZEntityRef parent = {}) -> ZEntityRef;
+
+private:
+	struct EntityTypeData {
+		ZEntityType type;
+		TArray<ZEntityProperty> propertyArray;
+		TArray<ZEntityInterface> interfaceArray;
+		std::vector<ZEntityProperty> properties;
+		std::vector<ZEntityPropertyType> propertyTypes;
+		std::vector<ZClassProperty> classProperties;
+		ZEntityInterface entityInterface;
+		size_t size = 0;
+	};
+
+	struct EntityData {
+		EntityTypeData* typeData;
+		ZEntityType type;
+		std::byte* memory;
+	};
+
+	std::deque<std::unique_ptr<IType>> typeInfos;
+	std::deque<std::unique_ptr<IEnumType>> enumInfos;
+	std::deque<std::vector<IEnumType::SEnumItem>> enumItems;
+	std::deque<STypeID> types;
+	std::deque<EntityTypeData> entityTypes;
+	std::deque<EntityData> entities;
+	uint64 nextEntityId = 1;
+};
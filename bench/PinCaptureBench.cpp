@@ -0,0 +1,271 @@
+#include "BenchWorld.h"
+#include "SlabArena.h"
+#include <benchmark/benchmark.h>
+#include <string>
+#include <vector>
+
+// Hook, drain and decode into pin history: the whole path an accepted call takes.
+static void BM_AcceptPath(benchmark::State& state) {
+	BenchScene s_Scene;
+	MockCaptureHost s_Host;
+	PinCapture s_Capture(s_Host);
+	const auto s_Batch = static_cast<size_t>(state.range(0));
+	size_t next = 0;
+
+	s_Capture.SetRateLimit(false, 15.f, 0);
+	const auto s_ArenaBefore = SlabArena::Global().GetStats();
+	const auto s_HeapBefore = HeapAllocations();
+
+	for (auto _ : state) {
+		for (size_t i = 0; i < s_Batch; ++i, ++next) {
+			const auto& call = s_Scene.calls[next % s_Scene.calls.size()];
+			s_Capture.OnPinOutput(call.entity, call.pinId, MockObjectRef(s_Scene.floatType, &s_Scene.payload));
+		}
+
+		s_Capture.Update(&s_Scene.scene);
+	}
+
+	state.SetItemsProcessed(state.iterations() * s_Batch);
+	state.counters["heap_allocs_per_call"] = static_cast<double>(HeapAllocations() - s_HeapBefore) / (state.iterations() * s_Batch);
+
+	// Share of the call data allocations served from a free list rather than new slab or heap memory.
+	const auto s_Arena = SlabArena::Global().GetStats();
+	const auto s_Allocations = s_Arena.allocations - s_ArenaBefore.allocations;
+	state.counters["arena_reused"] = s_Allocations ? static_cast<double>(s_Arena.reused - s_ArenaBefore.reused) / s_Allocations : 0;
+}
+BENCHMARK(BM_AcceptPath)->Arg(1)->Arg(64)->Arg(1024);
+
+// Accept path with a memory budget (in KiB) small enough that most calls evict something.
+static void BM_AcceptPathOverBudget(benchmark::State& state) {
+	BenchScene s_Scene;
+	MockCaptureHost s_Host;
+	PinCapture s_Capture(s_Host);
+	size_t next = 0;
+
+	s_Capture.SetRateLimit(false, 15.f, 0);
+	s_Capture.SetPinLimit(100000);
+	s_Capture.SetMemoryBudget(static_cast<size_t>(state.range(0)) * 1024);
+
+	for (auto _ : state) {
+		for (size_t i = 0; i < 64; ++i, ++next) {
+			const auto& call = s_Scene.calls[next % s_Scene.calls.size()];
+			s_Capture.OnPinOutput(call.entity, call.pinId, MockObjectRef(s_Scene.floatType, &s_Scene.payload));
+		}
+
+		s_Capture.Update(&s_Scene.scene);
+	}
+
+	state.SetItemsProcessed(state.iterations() * 64);
+	state.counters["evicted_pins"] = static_cast<double>(s_Capture.EvictedPins());
+	state.counters["retained_kib"] = static_cast<double>(s_Capture.RetainedBytes()) / 1024;
+}
+BENCHMARK(BM_AcceptPathOverBudget)->Arg(64)->Arg(1024);
+
+// Hook only, the cost the game pays per accepted call before the frame update.
+static void BM_HookEnqueue(benchmark::State& state) {
+	BenchScene s_Scene;
+	MockCaptureHost s_Host;
+	PinCapture s_Capture(s_Host);
+	size_t next = 0;
+
+	s_Capture.SetRateLimit(false, 15.f, 0);
+
+	for (auto _ : state) {
+		const auto& call = s_Scene.calls[next++ % s_Scene.calls.size()];
+		benchmark::DoNotOptimize(s_Capture.OnPinOutput(call.entity, call.pinId, MockObjectRef(s_Scene.floatType, &s_Scene.payload)));
+
+		// Drain without timing it so the ring never fills up.
+		if (next % 1024 == 0) {
+			state.PauseTiming();
+			s_Capture.Update(&s_Scene.scene);
+			state.ResumeTiming();
+		}
+	}
+
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_HookEnqueue);
+
+static void BM_HookRejectPinBlacklist(benchmark::State& state) {
+	BenchScene s_Scene;
+	MockCaptureHost s_Host;
+	PinCapture s_Capture(s_Host);
+	const auto& s_Call = s_Scene.calls.front();
+
+	s_Capture.BlacklistPin(s_Call.pinId);
+
+	for (auto _ : state)
+		benchmark::DoNotOptimize(s_Capture.OnPinOutput(s_Call.entity, s_Call.pinId, MockObjectRef(s_Scene.floatType, &s_Scene.payload)));
+
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_HookRejectPinBlacklist);
+
+static void BM_HookRejectEntityTypeBlacklist(benchmark::State& state) {
+	BenchScene s_Scene;
+	MockCaptureHost s_Host;
+	PinCapture s_Capture(s_Host);
+	const auto& s_Call = s_Scene.calls.front();
+
+	s_Capture.BlacklistEntityType(s_Call.pinId, GetEntityInterfaceType(s_Call.entity->GetType()));
+
+	for (auto _ : state)
+		benchmark::DoNotOptimize(s_Capture.OnPinOutput(s_Call.entity, s_Call.pinId, MockObjectRef(s_Scene.floatType, &s_Scene.payload)));
+
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_HookRejectEntityTypeBlacklist);
+
+static void BM_HookRejectRateLimit(benchmark::State& state) {
+	BenchScene s_Scene;
+	MockCaptureHost s_Host;
+	PinCapture s_Capture(s_Host);
+	const auto& s_Call = s_Scene.calls.front();
+
+	// A rate this low is exhausted by the first few calls, after which everything is rejected.
+	s_Capture.SetRateLimit(true, 0.01f, 0);
+
+	for (auto _ : state)
+		benchmark::DoNotOptimize(s_Capture.OnPinOutput(s_Call.entity, s_Call.pinId, MockObjectRef(s_Scene.floatType, &s_Scene.payload)));
+
+	s_Capture.Update(&s_Scene.scene);
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_HookRejectRateLimit);
+
+// Hook over the call mix with a capture trigger. The second trigger is written property first, but its entity
+// type test runs first and rejects most calls before the property is read. The last one reads a property on
+// every call and lets them all through.
+static void BM_HookTrigger(benchmark::State& state) {
+	static const char* const s_Triggers[] = {
+		"",
+		"pin == Pin65536",
+		"prop[\"m_bEnabled\"] && entityType ~ \"ZTrigger*\"",
+		"prop[\"m_fValue\"] >= 0",
+	};
+
+	BenchScene s_Scene;
+	MockCaptureHost s_Host;
+	PinCapture s_Capture(s_Host);
+	size_t next = 0;
+	uint64 accepted = 0;
+
+	s_Capture.SetRateLimit(false, 15.f, 0);
+	s_Capture.SetTrigger(s_Triggers[state.range(0)]);
+	state.SetLabel(s_Triggers[state.range(0)]);
+
+	for (auto _ : state) {
+		const auto& call = s_Scene.calls[next++ % s_Scene.calls.size()];
+		accepted += s_Capture.OnPinOutput(call.entity, call.pinId, MockObjectRef(s_Scene.floatType, &s_Scene.payload));
+
+		if (next % 1024 == 0) {
+			state.PauseTiming();
+			s_Capture.Update(&s_Scene.scene);
+			state.ResumeTiming();
+		}
+	}
+
+	state.SetItemsProcessed(state.iterations());
+	state.counters["accepted"] = static_cast<double>(accepted) / state.iterations();
+}
+BENCHMARK(BM_HookTrigger)->DenseRange(0, 3);
+
+// Rebuilding the UI snapshot after a frame's worth of calls, for different numbers of captured pins.
+static void BM_PublishSnapshot(benchmark::State& state) {
+	const auto s_PinCount = static_cast<size_t>(state.range(0));
+	BenchScene s_Scene(s_PinCount);
+	MockCaptureHost s_Host;
+	PinCapture s_Capture(s_Host);
+	size_t next = 0;
+
+	s_Capture.SetRateLimit(false, 15.f, 0);
+	s_Capture.SetPinLimit(s_PinCount);
+
+	// Fill every pin's history first so the snapshot has its full size from the first iteration.
+	for (const auto& call : s_Scene.calls)
+		s_Capture.OnPinOutput(call.entity, call.pinId, MockObjectRef(s_Scene.floatType, &s_Scene.payload));
+	s_Capture.Update(&s_Scene.scene);
+
+	for (auto _ : state) {
+		state.PauseTiming();
+		for (size_t i = 0; i < 16; ++i, ++next) {
+			const auto& call = s_Scene.calls[next % s_Scene.calls.size()];
+			s_Capture.OnPinOutput(call.entity, call.pinId, MockObjectRef(s_Scene.floatType, &s_Scene.payload));
+		}
+		s_Capture.Update(&s_Scene.scene);
+		state.ResumeTiming();
+
+		s_Capture.PublishSnapshot();
+	}
+}
+BENCHMARK(BM_PublishSnapshot)->Arg(50)->Arg(200)->Arg(1000);
+
+// Names of a captured call as PinCallData held them before they were interned: the entity ID formatted as
+// hex and the entity name and type copied into owned strings.
+struct LegacyCallNames {
+	std::string entityId;
+	std::string entityName;
+	std::string entityType;
+};
+
+struct InternedCallNames {
+	uint64 entityId = 0;
+	Symbol entityName = 0;
+	Symbol entityType = 0;
+};
+
+// Resolving the names of each captured call as owned strings (0) or interned (1), keeping the last 2000 calls
+// like 200 pins with 10 calls each. Reports heap allocations per call and the bytes a kept call holds for its
+// names. Interned strings are stored once for all calls and aren't included.
+static void BM_CallNames(benchmark::State& state) {
+	static constexpr size_t RetainedCalls = 2000;
+
+	struct Call {
+		uint64 entityId;
+		std::string entityName;
+		const char* entityType;
+	};
+
+	BenchScene s_Scene;
+	const auto s_Interned = state.range(0) != 0;
+	std::vector<Call> s_Calls;
+
+	// Named the way the game's entities usually are, long enough to not fit in the small string buffer.
+	for (const auto& call : s_Scene.calls) {
+		const auto s_Type = call.entity->GetType();
+		const auto s_TypeName = GetEntityInterfaceType(s_Type)->typeInfo()->m_pTypeName;
+		s_Calls.push_back({ s_Type->m_nEntityId, std::format("{}_{:04}", s_TypeName, s_Type->m_nEntityId % 10000), s_TypeName });
+	}
+
+	std::vector<LegacyCallNames> s_Legacy(RetainedCalls);
+	std::vector<InternedCallNames> s_InternedNames(RetainedCalls);
+	const auto s_HeapBefore = HeapAllocations();
+	size_t next = 0;
+
+	for (auto _ : state) {
+		const auto& call = s_Calls[next % s_Calls.size()];
+		const auto s_Slot = next++ % RetainedCalls;
+
+		if (s_Interned)
+			s_InternedNames[s_Slot] = { call.entityId, Intern(call.entityName), Intern(call.entityType) };
+		else
+			s_Legacy[s_Slot] = { std::format("{:016X}", call.entityId), call.entityName, call.entityType };
+	}
+
+	state.SetItemsProcessed(state.iterations());
+	state.counters["heap_allocs_per_call"] = static_cast<double>(HeapAllocations() - s_HeapBefore) / state.iterations();
+
+	size_t s_Bytes = 0;
+	if (s_Interned)
+		s_Bytes = sizeof(InternedCallNames) * RetainedCalls;
+	else {
+		const auto s_InlineCapacity = std::string().capacity();
+		for (const auto& names : s_Legacy) {
+			s_Bytes += sizeof(LegacyCallNames);
+			for (const auto* str : { &names.entityId, &names.entityName, &names.entityType })
+				s_Bytes += str->capacity() > s_InlineCapacity ? str->capacity() + 1 : 0;
+		}
+	}
+	state.counters["name_bytes_per_call"] = static_cast<double>(s_Bytes) / RetainedCalls;
+}
+BENCHMARK(BM_CallNames)->Arg(0)->Arg(1)->ArgName("interned");
@@ -0,0 +1,230 @@
+#include "BenchWorld.h"
+#include "EntityLayoutCache.h"
+#include "PropertyDecoders.h"
+#include "PropertySnapshot.h"
+#include <benchmark/benchmark.h>
+#include <array>
+#include <memory>
+#include <string>
+
+// The std::string type name compare chain PropertyDecoders replaced, kept as the baseline.
+static auto LegacyDecode(STypeID* p_Type, void* p_Data) -> PropertyInfo {
+	const std::string s_TypeName = p_Type->typeInfo()->m_pTypeName;
+
+	if (s_TypeName == "ZString")
+		return Properties::StringProperty(p_Type, p_Data);
+	else if (s_TypeName == "bool")
+		return Properties::BoolProperty(p_Type, p_Data);
+	else if (s_TypeName == "uint8")
+		return Properties::Uint8Property(p_Type, p_Data);
+	else if (s_TypeName == "int8")
+		return Properties::Int8Property(p_Type, p_Data);
+	else if (s_TypeName == "uint16")
+		return Properties::Uint16Property(p_Type, p_Data);
+	else if (s_TypeName == "int16")
+		return Properties::Int16Property(p_Type, p_Data);
+	else if (s_TypeName == "uint32")
+		return Properties::Uint32Property(p_Type, p_Data);
+	else if (s_TypeName == "int32")
+		return Properties::Int32Property(p_Type, p_Data);
+	else if (s_TypeName == "uint64")
+		return Properties::Uint64Property(p_Type, p_Data);
+	else if (s_TypeName == "int64")
+		return Properties::Int64Property(p_Type, p_Data);
+	else if (s_TypeName == "float32")
+		return Properties::Float32Property(p_Type, p_Data);
+	else if (s_TypeName == "float64")
+		return Properties::Float64Property(p_Type, p_Data);
+	else if (s_TypeName == "SVector2")
+		return Properties::SVector2Property(p_Type, p_Data);
+	else if (s_TypeName == "SVector3")
+		return Properties::SVector3Property(p_Type, p_Data);
+	else if (s_TypeName == "SVector4")
+		return Properties::SVector4Property(p_Type, p_Data);
+	else if (s_TypeName == "SMatrix43")
+		return Properties::SMatrix43Property(p_Type, p_Data);
+	else if (s_TypeName == "SColorRGB")
+		return Properties::SColorRGBProperty(p_Type, p_Data);
+	else if (s_TypeName == "SColorRGBA")
+		return Properties::SColorRGBAProperty(p_Type, p_Data);
+	else if (s_TypeName == "ZRepositoryID")
+		return Properties::ZRepositoryIDProperty(p_Type, static_cast<ZRepositoryID*>(p_Data));
+	else if (s_TypeName == "ZDynamicObject")
+		return Properties::ZDynamicObjectProperty(p_Type, static_cast<ZDynamicObject*>(p_Data));
+	else if (p_Type->typeInfo()->isEnum())
+		return Properties::EnumProperty(p_Type, p_Data);
+	else if (p_Type->typeInfo()->isResource())
+		return Properties::ResourceProperty(p_Type, p_Data);
+
+	return Properties::UnsupportedProperty(p_Type, p_Data);
+}
+
+// Decoding and formatting a single payload, as done for every accepted call.
+template <typename T>
+static void BM_PayloadFormat(benchmark::State& state, const char* typeName, T value) {
+	MockWorld s_World;
+	const auto s_Type = s_World.Type<T>(typeName);
+	std::string out;
+
+	for (auto _ : state) {
+		const auto decoder = PropertyDecoders::Resolve(s_Type);
+		const auto prop = decoder.decode(s_Type, &value);
+		PropertyInfo::FormatBuffer buffer;
+		out.assign(prop.Format(buffer));
+		benchmark::DoNotOptimize(out.data());
+	}
+
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_CAPTURE(BM_PayloadFormat, bool, "bool", true);
+BENCHMARK_CAPTURE(BM_PayloadFormat, int32, "int32", int32(-123456));
+BENCHMARK_CAPTURE(BM_PayloadFormat, float32, "float32", 3.14159f);
+BENCHMARK_CAPTURE(BM_PayloadFormat, SVector3, "SVector3", SVector3{ 1.5f, -2.25f, 1000.f });
+BENCHMARK_CAPTURE(BM_PayloadFormat, SMatrix43, "SMatrix43", SMatrix43{ { 1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 }, { 10, 20, 30 } });
+BENCHMARK_CAPTURE(BM_PayloadFormat, ZString, "ZString", ZString("Level_Paris_Main_Courtyard"));
+
+static void BM_PayloadFormatEnum(benchmark::State& state) {
+	static const IEnumType::SEnumItem s_Items[] = { { "eNone", 0 }, { "eFirst", 1 }, { "eSecond", 2 } };
+	MockWorld s_World;
+	const auto s_Type = s_World.EnumType("EMockEnum", s_Items);
+	int32 value = 2;
+	std::string out;
+
+	for (auto _ : state) {
+		const auto decoder = PropertyDecoders::Resolve(s_Type);
+		const auto prop = decoder.decode(s_Type, &value);
+		PropertyInfo::FormatBuffer buffer;
+		out.assign(prop.Format(buffer));
+		benchmark::DoNotOptimize(out.data());
+	}
+
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PayloadFormatEnum);
+
+// BM_PayloadFormat dispatched through LegacyDecode. The formatting is the same, so the difference between
+// the two is the dispatch.
+template <typename T>
+static void BM_PayloadFormatLegacy(benchmark::State& state, const char* typeName, T value) {
+	MockWorld s_World;
+	const auto s_Type = s_World.Type<T>(typeName);
+	std::string out;
+
+	for (auto _ : state) {
+		const auto prop = LegacyDecode(s_Type, &value);
+		PropertyInfo::FormatBuffer buffer;
+		out.assign(prop.Format(buffer));
+		benchmark::DoNotOptimize(out.data());
+	}
+
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_CAPTURE(BM_PayloadFormatLegacy, bool, "bool", true);
+BENCHMARK_CAPTURE(BM_PayloadFormatLegacy, int32, "int32", int32(-123456));
+BENCHMARK_CAPTURE(BM_PayloadFormatLegacy, float32, "float32", 3.14159f);
+BENCHMARK_CAPTURE(BM_PayloadFormatLegacy, SVector3, "SVector3", SVector3{ 1.5f, -2.25f, 1000.f });
+BENCHMARK_CAPTURE(BM_PayloadFormatLegacy, SMatrix43, "SMatrix43", SMatrix43{ { 1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 }, { 10, 20, 30 } });
+BENCHMARK_CAPTURE(BM_PayloadFormatLegacy, ZString, "ZString", ZString("Level_Paris_Main_Courtyard"));
+
+static void BM_PayloadFormatLegacyEnum(benchmark::State& state) {
+	static const IEnumType::SEnumItem s_Items[] = { { "eNone", 0 }, { "eFirst", 1 }, { "eSecond", 2 } };
+	MockWorld s_World;
+	const auto s_Type = s_World.EnumType("EMockEnum", s_Items);
+	int32 value = 2;
+	std::string out;
+
+	for (auto _ : state) {
+		const auto prop = LegacyDecode(s_Type, &value);
+		PropertyInfo::FormatBuffer buffer;
+		out.assign(prop.Format(buffer));
+		benchmark::DoNotOptimize(out.data());
+	}
+
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PayloadFormatLegacyEnum);
+
+// An entity type with `count` properties cycling through a few common types.
+static auto MakePropertyEntity(MockWorld& world, size_t count) -> ZEntityRef {
+	static std::vector<std::string> s_Names;
+	const STypeID* s_Types[] = {
+		world.Type<float32>("float32"),
+		world.Type<SVector3>("SVector3"),
+		world.Type<ZString>("ZString"),
+		world.Type<bool>("bool"),
+		world.Type<SMatrix43>("SMatrix43"),
+	};
+
+	while (s_Names.size() < count)
+		s_Names.push_back("m_Property" + std::to_string(s_Names.size()));
+
+	std::vector<MockProperty> props;
+	for (size_t i = 0; i < count; ++i)
+		props.push_back({ s_Names[i].c_str(), const_cast<STypeID*>(s_Types[i % std::size(s_Types)]) });
+
+	return world.Entity(world.EntityType("ZPropertyEntity", props));
+}
+
+// Raw property copy done on the game thread for every accepted call.
+static void BM_PropertyCapture(benchmark::State& state) {
+	MockWorld s_World;
+	EntityLayoutCache s_LayoutCache;
+	const auto s_Entity = MakePropertyEntity(s_World, static_cast<size_t>(state.range(0)));
+
+	for (auto _ : state) {
+		auto snapshot = PropertySnapshot::Capture(s_Entity, s_LayoutCache.Get(s_Entity->GetType()));
+		benchmark::DoNotOptimize(snapshot.get());
+	}
+
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_PropertyCapture)->Arg(4)->Arg(16)->Arg(64);
+
+// Repeated captures of one entity with a single value changing between them, as keyframes only or delta
+// encoded, reporting the bytes each call retains. The last ten captures are kept like a pin's call history
+// would, as the history only refers to captures that are still held.
+static void BM_PropertyDeltaCapture(benchmark::State& state, bool delta) {
+	MockWorld s_World;
+	EntityLayoutCache s_LayoutCache;
+	const auto s_Entity = MakePropertyEntity(s_World, static_cast<size_t>(state.range(0)));
+	const auto s_Layout = s_LayoutCache.Get(s_Entity->GetType());
+	auto* s_Value = reinterpret_cast<float32*>(reinterpret_cast<std::byte*>(s_Entity.m_pEntity) + s_Layout->properties[0].entityOffset);
+	PropertyHistory s_History;
+	std::array<std::shared_ptr<PropertySnapshot>, 10> s_Calls;
+	size_t s_Bytes = 0;
+	size_t s_Call = 0;
+
+	for (auto _ : state) {
+		*s_Value += 1.f;
+		auto& snapshot = s_Calls[s_Call++ % s_Calls.size()];
+		snapshot = PropertySnapshot::Capture(s_Entity, s_Layout, delta ? &s_History : nullptr);
+		s_Bytes += snapshot->MemoryUsage();
+		benchmark::DoNotOptimize(snapshot.get());
+	}
+
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+	state.counters["bytes_per_call"] = static_cast<double>(s_Bytes) / state.iterations();
+}
+BENCHMARK_CAPTURE(BM_PropertyDeltaCapture, keyframes, false)->Arg(16)->Arg(64);
+BENCHMARK_CAPTURE(BM_PropertyDeltaCapture, delta, true)->Arg(16)->Arg(64);
+
+// Decoding a captured snapshot, done the first time the UI displays the call.
+static void BM_PropertyMaterialize(benchmark::State& state) {
+	MockWorld s_World;
+	EntityLayoutCache s_LayoutCache;
+	const auto s_Entity = MakePropertyEntity(s_World, static_cast<size_t>(state.range(0)));
+
+	for (auto _ : state) {
+		state.PauseTiming();
+		auto snapshot = PropertySnapshot::Capture(s_Entity, s_LayoutCache.Get(s_Entity->GetType()));
+		state.ResumeTiming();
+
+		PropertyInfo::FormatBuffer buffer;
+		for (auto& prop : snapshot->Materialize())
+			benchmark::DoNotOptimize(prop.Format(buffer).data());
+	}
+
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+	state.counters["property_bytes"] = sizeof(PropertyInfo);
+}
+BENCHMARK(BM_PropertyMaterialize)->Arg(4)->Arg(16)->Arg(64);
@@ -0,0 +1,93 @@
+#include "CaptureRing.h"
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// Same size and shape as PinCaptureRecord, without the SDK types.
+struct SyntheticRecord {
+	uint64_t entity;
+	uint64_t entityType;
+	uint64_t entityId;
+	uint64_t dataType;
+	int64_t timestamp;
+	uint32_t pinId;
+	bool hasData;
+	alignas(16) std::byte data[64];
+};
+
+using SyntheticRing = CaptureRing<SyntheticRecord, 4096>;
+
+// Producers push synthetic records at a fixed combined rate while one consumer drains the ring every
+// `drain_us` microseconds, like the frame update does. Each iteration covers 50 ms of traffic. Reports the
+// push throughput reached and how many records were dropped because the ring was full.
+static void BM_CaptureRingThroughput(benchmark::State& state) {
+	const auto s_Producers = static_cast<size_t>(state.range(0));
+	const auto s_Rate = static_cast<double>(state.range(1)) * 1000;
+	const auto s_DrainInterval = std::chrono::microseconds(state.range(2));
+	const auto s_RecordsPerProducer = static_cast<size_t>(s_Rate * 0.05 / s_Producers);
+	const auto s_Period = std::chrono::duration<double>(s_Producers / s_Rate);
+	uint64_t pushed = 0;
+	uint64_t dropped = 0;
+
+	for (auto _ : state) {
+		auto ring = std::make_unique<SyntheticRing>();
+		std::atomic<size_t> running = s_Producers;
+		std::vector<std::thread> producers;
+
+		std::thread consumer([&] {
+			uint64_t checksum = 0;
+
+			for (;;) {
+				const auto s_Done = running.load(std::memory_order_acquire) == 0;
+				ring->Drain([&](SyntheticRecord& record) { checksum += record.pinId; });
+				if (s_Done) break;
+				std::this_thread::sleep_for(s_DrainInterval);
+			}
+
+			benchmark::DoNotOptimize(checksum);
+		});
+
+		const auto s_Start = std::chrono::steady_clock::now();
+
+		for (size_t p = 0; p < s_Producers; ++p) {
+			producers.emplace_back([&, p] {
+				for (size_t i = 0; i < s_RecordsPerProducer; ++i) {
+					const auto s_Due = s_Start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(s_Period * i);
+					while (std::chrono::steady_clock::now() < s_Due) {}
+
+					ring->TryPush([&](SyntheticRecord& record) {
+						record.entity = 0x10000 + i;
+						record.entityType = 0x20000 + i;
+						record.entityId = i;
+						record.dataType = 0;
+						record.timestamp = static_cast<int64_t>(i);
+						record.pinId = static_cast<uint32_t>(p);
+						record.hasData = true;
+						std::memset(record.data, 0, sizeof(float));
+					});
+				}
+
+				running.fetch_sub(1, std::memory_order_release);
+			});
+		}
+
+		for (auto& producer : producers)
+			producer.join();
+		consumer.join();
+
+		pushed += ring->Pushed();
+		dropped += ring->Dropped();
+	}
+
+	state.SetItemsProcessed(static_cast<int64_t>(pushed + dropped));
+	state.counters["drop_rate"] = pushed + dropped ? static_cast<double>(dropped) / (pushed + dropped) : 0;
+}
+BENCHMARK(BM_CaptureRingThroughput)
+	->ArgsProduct({ { 1, 2 }, { 100, 1000, 10000 }, { 1000, 16000 } })
+	->ArgNames({ "producers", "krecords_per_s", "drain_us" })
+	->UseRealTime()
+	->Unit(benchmark::kMillisecond);
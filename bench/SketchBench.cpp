@@ -0,0 +1,72 @@
+#include "SpaceSaving.h"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <utility>
+#include <vector>
+
+using HotPinKey = std::pair<uint32_t, uint64_t>;
+
+// Zipf distributed (pin, entity) stream: a few pairs make up most calls with a long tail of rare ones,
+// which is what a level full of timers and triggers looks like.
+static auto MakeSkewedStream(double skew, size_t distinct, size_t length) -> std::vector<HotPinKey> {
+	std::vector<double> cdf(distinct);
+	double sum = 0;
+
+	for (size_t i = 0; i < distinct; ++i)
+		cdf[i] = sum += 1.0 / std::pow(static_cast<double>(i + 1), skew);
+
+	std::mt19937 rng(1234);
+	std::uniform_real_distribution<double> dist(0, sum);
+	std::vector<HotPinKey> stream;
+	stream.reserve(length);
+
+	for (size_t i = 0; i < length; ++i) {
+		const auto rank = static_cast<size_t>(std::lower_bound(cdf.begin(), cdf.end(), dist(rng)) - cdf.begin());
+		stream.emplace_back(static_cast<uint32_t>(0x10000 + rank % 512), 0x1000000 + rank);
+	}
+
+	return stream;
+}
+
+// Cost per call in the hook, plus how well the sketch's top 10 matches the exact one. Skew is given in tenths.
+static void BM_HotPinsSketch(benchmark::State& state) {
+	const auto s_Skew = static_cast<double>(state.range(0)) / 10;
+	const auto s_Stream = MakeSkewedStream(s_Skew, 100000, 1 << 20);
+	SpaceSaving<HotPinKey> sketch(512);
+	size_t next = 0;
+
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(sketch.Add(s_Stream[next]));
+		if (++next == s_Stream.size()) next = 0;
+	}
+
+	state.SetItemsProcessed(state.iterations());
+
+	// Accuracy over one pass of the stream, outside of the timed loop.
+	SpaceSaving<HotPinKey> s_Check(512);
+	FlatHashMap<HotPinKey, uint64_t> s_Exact;
+
+	for (auto& key : s_Stream) {
+		s_Check.Add(key);
+		++s_Exact[key];
+	}
+
+	std::vector<std::pair<uint64_t, HotPinKey>> s_ExactTop;
+	s_Exact.ForEach([&](const HotPinKey& key, uint64_t count) { s_ExactTop.emplace_back(count, key); });
+	std::partial_sort(s_ExactTop.begin(), s_ExactTop.begin() + 10, s_ExactTop.end(), std::greater<>());
+
+	size_t s_Found = 0;
+	uint64_t s_WorstError = 0;
+
+	for (auto& counter : s_Check.Top(10)) {
+		s_Found += std::any_of(s_ExactTop.begin(), s_ExactTop.begin() + 10, [&](auto& exact) { return exact.second == counter.key; });
+		s_WorstError = std::max(s_WorstError, counter.count - *s_Exact.Find(counter.key));
+	}
+
+	state.counters["top10_recall"] = static_cast<double>(s_Found) / 10;
+	state.counters["top10_worst_error"] = static_cast<double>(s_WorstError);
+	state.counters["error_bound"] = static_cast<double>(s_Check.MaxError());
+}
+BENCHMARK(BM_HotPinsSketch)->Arg(8)->Arg(10)->Arg(12);
@@ -0,0 +1,16 @@
+#pragma once
+#include <Glacier/ZObject.h>
+
+template <typename T>
+struct MockFunction;
+
+template <typename R, typename... Args>
+struct MockFunction<R(Args...)> {
+	R (*fn)(Args...);
+
+	auto Call(Args... args) -> R { return fn(args...); }
+};
+
+namespace Functions {
+	extern MockFunction<void(ZDynamicObject*, ZString*)>* ZDynamicObject_ToString;
+}
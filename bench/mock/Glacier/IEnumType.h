@@ -0,0 +1,12 @@
+#pragma once
+#include "ZObject.h"
+
+class IEnumType : public IType {
+public:
+	struct SEnumItem {
+		const char* m_pName = "";
+		int32 m_nValue = 0;
+	};
+
+	TArray<SEnumItem> m_entries;
+};
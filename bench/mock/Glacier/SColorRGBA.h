@@ -0,0 +1,6 @@
+#pragma once
+#include "ZPrimitives.h"
+
+struct SColorRGBA {
+	float32 r = 0, g = 0, b = 0, a = 0;
+};
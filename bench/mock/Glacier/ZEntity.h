@@ -0,0 +1,65 @@
+#pragma once
+#include "ZObject.h"
+
+namespace EPropertyInfoFlags {
+	enum : uint32 {
+		E_HAS_GETTER_SETTER = 0x01,
+	};
+}
+
+struct ZClassProperty {
+	const char* m_pName = "";
+	uint32 m_nPropertyID = 0;
+	STypeID* m_pType = nullptr;
+	int64 m_nOffset = 0;
+	uint32 m_nFlags = 0;
+	void (*set)(void*, void*, uint64, bool) = nullptr;
+	void (*get)(void*, void*, uint64) = nullptr;
+};
+
+struct ZEntityPropertyType {
+	auto getPropertyInfo() const -> ZClassProperty* { return m_pPropertyInfo; }
+
+	ZClassProperty* m_pPropertyInfo = nullptr;
+};
+
+struct ZEntityProperty {
+	uint32 m_nPropertyId = 0;
+	uint64 m_nOffset = 0;
+	ZEntityPropertyType* m_pType = nullptr;
+};
+
+struct ZEntityInterface {
+	STypeID* m_pTypeId = nullptr;
+	int64 m_nOffset = 0;
+};
+
+struct ZEntityType {
+	int64 m_nUnk01 = 0;
+	TArray<ZEntityProperty>* m_pProperties01 = nullptr;
+	TArray<ZEntityProperty>* m_pProperties02 = nullptr;
+	TArray<ZEntityInterface>* m_pInterfaces = nullptr;
+	uint64 m_nEntityId = 0;
+};
+
+// Mock entities start with their type, followed by their logical parent and then their properties.
+class ZEntityImpl {
+public:
+	auto GetType() const -> ZEntityType* { return *reinterpret_cast<ZEntityType* const*>(this); }
+};
+
+class ZEntityRef {
+public:
+	ZEntityRef() = default;
+	explicit ZEntityRef(ZEntityType** entity) : m_pEntity(entity) {}
+
+	auto operator->() const -> ZEntityImpl* { return reinterpret_cast<ZEntityImpl*>(m_pEntity); }
+	explicit operator bool() const { return m_pEntity != nullptr; }
+	auto operator==(const ZEntityRef& other) const -> bool { return m_pEntity == other.m_pEntity; }
+
+	auto GetLogicalParent() const -> ZEntityRef {
+		return ZEntityRef(reinterpret_cast<ZEntityType** const*>(m_pEntity)[1]);
+	}
+
+	ZEntityType** m_pEntity = nullptr;
+};
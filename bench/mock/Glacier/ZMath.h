@@ -0,0 +1,21 @@
+#pragma once
+#include "ZPrimitives.h"
+
+struct SVector2 {
+	float32 x = 0, y = 0;
+};
+
+struct SVector3 {
+	float32 x = 0, y = 0, z = 0;
+};
+
+struct SVector4 {
+	float32 x = 0, y = 0, z = 0, w = 0;
+};
+
+struct SMatrix43 {
+	SVector3 XAxis;
+	SVector3 YAxis;
+	SVector3 ZAxis;
+	SVector3 Trans;
+};
@@ -0,0 +1,73 @@
+#pragma once
+#include "ZPrimitives.h"
+
+enum ETypeInfoFlags : uint16 {
+	TIF_Entity = 0x01,
+	TIF_Resource = 0x02,
+	TIF_Class = 0x04,
+	TIF_Enum = 0x08,
+	TIF_Container = 0x10,
+	TIF_Primitive = 0x100,
+};
+
+struct STypeFunctions {
+	void (*construct)(void*);
+	void (*copyConstruct)(void*, const void*);
+	void (*destruct)(void*);
+	void (*assign)(void*, void*);
+	bool (*equal)(void*, void*);
+	bool (*smaller)(void*, void*);
+};
+
+class IType {
+public:
+	auto isEntity() const -> bool { return m_nTypeInfoFlags & TIF_Entity; }
+	auto isResource() const -> bool { return m_nTypeInfoFlags & TIF_Resource; }
+	auto isClass() const -> bool { return m_nTypeInfoFlags & TIF_Class; }
+	auto isEnum() const -> bool { return m_nTypeInfoFlags & TIF_Enum; }
+	auto isPrimitive() const -> bool { return m_nTypeInfoFlags & TIF_Primitive; }
+
+	STypeFunctions* m_pTypeFunctions = nullptr;
+	uint16 m_nTypeSize = 0;
+	uint16 m_nTypeAlignment = 0;
+	uint16 m_nTypeInfoFlags = 0;
+	const char* m_pTypeName = "";
+};
+
+struct STypeID {
+	auto typeInfo() const -> IType* {
+		return pTypeInfo || !pSourceType ? pTypeInfo : pSourceType->pTypeInfo;
+	}
+
+	uint16 flags = 0;
+	uint16 typeNum = 0;
+	IType* pTypeInfo = nullptr;
+	STypeID* pSourceType = nullptr;
+};
+
+// Stands in for the game's type registry in Is<T>(). Only set for the types a benchmark registers, so
+// anything else takes the game's fallback path.
+template <typename T>
+inline STypeID* MockTypeId = nullptr;
+
+class ZObjectRef {
+public:
+	auto GetTypeID() const -> STypeID* { return m_pTypeID; }
+
+	template <typename T>
+	auto Is() const -> bool { return m_pTypeID && m_pTypeID == MockTypeId<T>; }
+
+	template <typename T>
+	auto As() const -> T* { return static_cast<T*>(m_pData); }
+
+protected:
+	STypeID* m_pTypeID = nullptr;
+	void* m_pData = nullptr;
+};
+
+class ZDynamicObject : public ZObjectRef {};
+
+struct SDynamicObjectKeyValuePair {
+	ZString sKey;
+	ZDynamicObject value;
+};
@@ -0,0 +1,52 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+
+using int8 = int8_t;
+using uint8 = uint8_t;
+using int16 = int16_t;
+using uint16 = uint16_t;
+using int32 = int32_t;
+using uint32 = uint32_t;
+using int64 = int64_t;
+using uint64 = uint64_t;
+using float32 = float;
+using float64 = double;
+
+template <typename A, typename B>
+constexpr auto min(A a, B b) -> std::common_type_t<A, B> {
+	using T = std::common_type_t<A, B>;
+	return static_cast<T>(a) < static_cast<T>(b) ? static_cast<T>(a) : static_cast<T>(b);
+}
+
+// Non-owning, unlike the game's ZString. The mock world keeps the characters alive.
+class ZString {
+public:
+	ZString() = default;
+	ZString(const char* str) : m_pChars(str), m_nLength(static_cast<uint32>(std::strlen(str))) {}
+	ZString(std::string_view str) : m_pChars(str.data()), m_nLength(static_cast<uint32>(str.size())) {}
+
+	auto c_str() const -> const char* { return m_pChars; }
+	auto size() const -> uint32 { return m_nLength; }
+	auto ToStringView() const -> std::string_view { return { m_pChars, m_nLength }; }
+
+private:
+	const char* m_pChars = "";
+	uint32 m_nLength = 0;
+};
+
+template <typename T>
+class TArray {
+public:
+	auto size() const -> size_t { return m_pEnd - m_pBegin; }
+	auto operator[](size_t index) const -> T& { return m_pBegin[index]; }
+	auto begin() const -> T* { return m_pBegin; }
+	auto end() const -> T* { return m_pEnd; }
+
+	T* m_pBegin = nullptr;
+	T* m_pEnd = nullptr;
+	T* m_pAllocationEnd = nullptr;
+};
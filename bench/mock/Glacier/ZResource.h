@@ -0,0 +1,33 @@
+#pragma once
+#include "ZPrimitives.h"
+#include <string>
+
+class ZRepositoryID {
+public:
+	auto ToString() const -> std::string;
+
+	uint64 m_nHigh = 0;
+	uint64 m_nLow = 0;
+};
+
+class ZRuntimeResourceID {
+public:
+	auto GetID() const -> uint64 { return m_nID; }
+
+	uint64 m_nID = 0;
+};
+
+struct SResourceInfo {
+	ZRuntimeResourceID rid;
+};
+
+struct ZResourceIndex {
+	int32 val = -1;
+};
+
+class ZResourcePtr {
+public:
+	auto GetResourceInfo() const -> SResourceInfo&;
+
+	ZResourceIndex m_nResourceIndex;
+};
@@ -0,0 +1,25 @@
+#include <Functions.h>
+#include <Glacier/ZResource.h>
+#include <ResourceLib_HM3.h>
+#include <format>
+
+auto ZRepositoryID::ToString() const -> std::string {
+	return std::format("{:016x}{:016x}", m_nHigh, m_nLow);
+}
+
+auto ZResourcePtr::GetResourceInfo() const -> SResourceInfo& {
+	static SResourceInfo s_Info;
+	s_Info.rid.m_nID = static_cast<uint64>(m_nResourceIndex.val);
+	return s_Info;
+}
+
+// The game writes JSON for the dynamic object types that aren't handled by the plugin.
+static MockFunction<void(ZDynamicObject*, ZString*)> s_ZDynamicObject_ToString = {
+	[](ZDynamicObject*, ZString* out) { *out = "null"; }
+};
+
+MockFunction<void(ZDynamicObject*, ZString*)>* Functions::ZDynamicObject_ToString = &s_ZDynamicObject_ToString;
+
+auto HM3_GetPropertyName(uint32_t) -> ResourceConverterStringView {
+	return { nullptr, 0 };
+}
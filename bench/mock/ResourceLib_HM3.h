@@ -0,0 +1,10 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+struct ResourceConverterStringView {
+	const char* Data;
+	size_t Size;
+};
+
+auto HM3_GetPropertyName(uint32_t propertyId) -> ResourceConverterStringView;
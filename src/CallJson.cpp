@@ -0,0 +1,184 @@
+#include "CallJson.h"
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <initializer_list>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+static auto WriteHexId(JsonWriter& writer, uint64 id) -> void {
+	char chars[16];
+	const auto s_End = std::to_chars(chars, chars + sizeof(chars), id, 16).ptr;
+
+	// Zero padded like the IDs shown in the UI.
+	char padded[16];
+	const auto s_Length = static_cast<size_t>(s_End - chars);
+	std::fill(padded, padded + sizeof(padded) - s_Length, '0');
+	std::copy(chars, s_End, padded + sizeof(padded) - s_Length);
+	writer.String(std::string_view(padded, sizeof(padded)));
+}
+
+static auto WriteVector(JsonWriter& writer, std::initializer_list<float32> components) -> void {
+	writer.BeginArray();
+	for (auto component : components)
+		writer.Float(component);
+	writer.EndArray();
+}
+
+static auto WriteColor(JsonWriter& writer, std::initializer_list<std::pair<std::string_view, float32>> channels) -> void {
+	writer.BeginObject();
+	for (auto& [channel, value] : channels) {
+		writer.Key(channel);
+		writer.Float(value);
+	}
+	writer.EndObject();
+}
+
+static auto WritePropertyValue(JsonWriter& writer, const PropertyInfo& prop) -> void {
+	std::visit([&](const auto& s_Value) {
+		using T = std::decay_t<decltype(s_Value)>;
+
+		if constexpr (std::is_same_v<T, std::monostate>)
+			writer.Null();
+		else if constexpr (std::is_same_v<T, std::string>)
+			writer.String(s_Value);
+		else if constexpr (std::is_same_v<T, PropertyInfo_Json>)
+			writer.Raw(s_Value.value);
+		else if constexpr (std::is_same_v<T, bool>)
+			writer.Bool(s_Value);
+		else if constexpr (std::is_same_v<T, int64>)
+			writer.Int(s_Value);
+		else if constexpr (std::is_same_v<T, uint64>)
+			writer.Uint(s_Value);
+		else if constexpr (std::is_same_v<T, float32>)
+			writer.Float(s_Value);
+		else if constexpr (std::is_same_v<T, float64>)
+			writer.Double(s_Value);
+		else if constexpr (std::is_same_v<T, PropertyInfo_EnumValue>) {
+			// Named like the UI shows them, with the number for values the enum doesn't list.
+			if (const auto s_Name = s_Value.Name())
+				writer.String(s_Name);
+			else
+				writer.Int(s_Value.value);
+		}
+		else if constexpr (std::is_same_v<T, SVector2>)
+			WriteVector(writer, { s_Value.x, s_Value.y });
+		else if constexpr (std::is_same_v<T, SVector3>)
+			WriteVector(writer, { s_Value.x, s_Value.y, s_Value.z });
+		else if constexpr (std::is_same_v<T, SVector4>)
+			WriteVector(writer, { s_Value.x, s_Value.y, s_Value.z, s_Value.w });
+		else if constexpr (std::is_same_v<T, SColorRGB>)
+			WriteColor(writer, { { "r", s_Value.r }, { "g", s_Value.g }, { "b", s_Value.b } });
+		else if constexpr (std::is_same_v<T, SColorRGBA>)
+			WriteColor(writer, { { "r", s_Value.r }, { "g", s_Value.g }, { "b", s_Value.b }, { "a", s_Value.a } });
+		else if constexpr (std::is_same_v<T, SMatrix43>) {
+			writer.BeginArray();
+			for (auto& axis : { s_Value.XAxis, s_Value.YAxis, s_Value.ZAxis, s_Value.Trans })
+				WriteVector(writer, { axis.x, axis.y, axis.z });
+			writer.EndArray();
+		}
+	}, prop.value);
+}
+
+auto WriteCallJson(JsonWriter& writer, const PinView& pin, const PinCallData& call) -> void {
+	writer.BeginObject();
+	writer.Key("pin");
+	writer.Uint(pin.id);
+	writer.Key("pinName");
+	writer.String(SymbolView(pin.name));
+	writer.Key("entityId");
+	WriteHexId(writer, call.entityId);
+	writer.Key("entityName");
+	writer.String(SymbolView(call.entityName));
+	writer.Key("entityType");
+	if (call.entityType)
+		writer.String(SymbolView(call.entityType));
+	else
+		writer.Null();
+	writer.Key("data");
+	writer.String(call.data);
+
+	// The tree is linked from the entity up, so it is collected first to be written from the root down.
+	thread_local std::vector<const EntityTreeNode*> s_TreePath;
+	s_TreePath.clear();
+	for (auto node = call.entityTree.get(); node; node = node->parent.get())
+		s_TreePath.push_back(node);
+
+	writer.Key("tree");
+	writer.BeginArray();
+	for (auto it = s_TreePath.rbegin(); it != s_TreePath.rend(); ++it) {
+		writer.BeginObject();
+		writer.Key("id");
+		WriteHexId(writer, (*it)->entityId);
+		writer.Key("name");
+		writer.String(SymbolView((*it)->name));
+		writer.EndObject();
+	}
+	writer.EndArray();
+
+	// Properties the UI hasn't decoded are decoded just for the export rather than kept around.
+	thread_local std::vector<PropertyInfo> s_Decoded;
+	const std::vector<PropertyInfo>* s_Props = nullptr;
+	if (call.props) {
+		s_Props = call.props->Materialized();
+		if (!s_Props) {
+			call.props->Decode(s_Decoded);
+			s_Props = &s_Decoded;
+		}
+	}
+
+	writer.Key("props");
+	writer.BeginArray();
+	if (s_Props) {
+		for (auto& prop : *s_Props) {
+			writer.BeginObject();
+			writer.Key("name");
+			writer.String(SymbolView(prop.name));
+			writer.Key("type");
+			writer.String(SymbolView(prop.typeName));
+			writer.Key("value");
+			WritePropertyValue(writer, prop);
+			writer.Key("changed");
+			writer.Bool(prop.changed);
+			writer.EndObject();
+		}
+	}
+	writer.EndArray();
+	s_Decoded.clear();
+
+	writer.EndObject();
+}
+
+auto FormatCallsJson(const PinSnapshot& snapshot, std::string& out) -> size_t {
+	JsonWriter writer;
+	size_t count = 0;
+
+	for (auto& pin : snapshot.pins) {
+		for (auto& call : pin->calls) {
+			writer.Clear();
+			WriteCallJson(writer, *pin, *call);
+
+			out.append(writer.View());
+			out += '\n';
+			++count;
+		}
+	}
+
+	return count;
+}
+
+auto WriteCallsJson(const std::filesystem::path& path, std::string_view ndjson) -> bool {
+#ifdef _WIN32
+	auto file = _wfopen(path.c_str(), L"wb");
+#else
+	auto file = std::fopen(path.c_str(), "wb");
+#endif
+
+	if (!file) return false;
+
+	const auto s_Written = std::fwrite(ndjson.data(), 1, ndjson.size(), file);
+	const auto s_Closed = std::fclose(file) == 0;
+	return s_Written == ndjson.size() && s_Closed;
+}
@@ -0,0 +1,17 @@
+#pragma once
+#include "JsonWriter.h"
+#include "PinCapture.h"
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+// JSON form of captured calls. Entity IDs are written as hex strings as they don't fit in a JSON number.
+
+// Writes a call of `pin` as one object: the pin, the entity, its tree from the root down and its properties.
+auto WriteCallJson(JsonWriter& writer, const PinView& pin, const PinCallData& call) -> void;
+
+// Appends every call in the snapshot to `out` as NDJSON, one object per line, and returns the number written.
+auto FormatCallsJson(const PinSnapshot& snapshot, std::string& out) -> size_t;
+// Writes the output of FormatCallsJson to a file. Does nothing else, so it can run off the game thread.
+auto WriteCallsJson(const std::filesystem::path& path, std::string_view ndjson) -> bool;
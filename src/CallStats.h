@@ -0,0 +1,68 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+// Streaming statistics of how often something is called, in constant memory. They aren't synchronized: the
+// capture side updates them on the game thread and the UI only ever sees copies. Intervals are kept in
+// nanoseconds.
+struct CallStats {
+	using Clock = std::chrono::steady_clock;
+
+	// Interval buckets are powers of two of microseconds: bucket 0 holds intervals under 1us, bucket N
+	// those from 2^(N-1)us up to 2^N us, and the last one everything from about 18 minutes up.
+	static constexpr size_t IntervalBuckets = 32;
+	// Weight of each new interval in the moving average the rate is derived from.
+	static constexpr double RateSmoothing = 1.0 / 16;
+
+	Clock::time_point firstSeen;
+	Clock::time_point lastSeen;
+	uint64_t count = 0;
+	int64_t minInterval = std::numeric_limits<int64_t>::max();
+	int64_t maxInterval = 0;
+	int64_t intervalSum = 0;
+	double averageInterval = 0;
+	std::array<uint32_t, IntervalBuckets> intervals{};
+
+	auto Record(Clock::time_point now) -> void {
+		if (count++ == 0) {
+			firstSeen = now;
+			lastSeen = now;
+			return;
+		}
+
+		// Calls are recorded in the order they were made, this only guards against a clock going backwards.
+		const auto interval = std::max<int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now - lastSeen).count(), 0);
+		lastSeen = std::max(lastSeen, now);
+		minInterval = std::min(minInterval, interval);
+		maxInterval = std::max(maxInterval, interval);
+		intervalSum += interval;
+		// The first interval seeds the average rather than being blended with nothing.
+		averageInterval += (static_cast<double>(interval) - averageInterval) * (count == 2 ? 1.0 : RateSmoothing);
+		++intervals[BucketFor(interval)];
+	}
+
+	// Calls per second, decaying once the pin has been quiet for longer than its recent average interval.
+	auto Rate(Clock::time_point now) const -> double {
+		if (count < 2) return 0;
+
+		const auto idle = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(now - lastSeen).count());
+		return 1e9 / std::max({ averageInterval, idle, 1.0 });
+	}
+
+	auto MeanInterval() const -> double {
+		return count < 2 ? 0 : static_cast<double>(intervalSum) / static_cast<double>(count - 1);
+	}
+
+	auto MinInterval() const -> int64_t {
+		return count < 2 ? 0 : minInterval;
+	}
+
+	static constexpr auto BucketFor(int64_t interval) -> size_t {
+		return std::min<size_t>(std::bit_width(static_cast<uint64_t>(interval) / 1000), IntervalBuckets - 1);
+	}
+};
@@ -0,0 +1,98 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// On-disk layout of a pin capture (.pincap) file. Everything is little-endian and 8-byte aligned so a
+// reader can memory-map the file and use these structs in place.
+//
+//   FileHeader
+//   Block*          each a BlockHeader followed by `size` bytes of payload
+//   Footer          only present if the capture was closed cleanly
+//
+// Strings blocks define the names used by the records that follow them, Records blocks hold fixed-size
+// Records followed by their variable-size data, and every few Records blocks an Index block lists their
+// offsets. Index blocks point back to the previous one, and the Footer points to the last, so a reader
+// can find every Records block and the names it uses without touching the rest of the file. Without a Footer, the blocks can
+// still be walked one by one from the start.
+namespace CaptureFormat {
+	inline constexpr char Magic[8] = { 'P', 'I', 'N', 'C', 'A', 'P', '\0', '\0' };
+	inline constexpr char FooterMagic[8] = { 'P', 'I', 'N', 'E', 'N', 'D', '\0', '\0' };
+	// Index entries of version 1 files point at the Records block rather than the batch, so those files are
+	// only read by walking their blocks.
+	inline constexpr uint32_t Version = 2;
+	inline constexpr uint32_t FirstIndexedVersion = 2;
+	inline constexpr size_t Alignment = 8;
+
+	constexpr auto AlignUp(size_t size) -> size_t {
+		return (size + Alignment - 1) & ~(Alignment - 1);
+	}
+
+	struct FileHeader {
+		char magic[8];
+		uint32_t version;
+		uint32_t headerSize;
+		// Wall clock time the capture started at, in nanoseconds since the Unix epoch.
+		uint64_t startTime;
+		uint64_t reserved;
+	};
+
+	enum class BlockType : uint32_t {
+		Strings = 1,
+		Records = 2,
+		Index = 3,
+	};
+
+	struct BlockHeader {
+		BlockType type;
+		// Number of entries in the block.
+		uint32_t count;
+		// Size of the payload following this header, always a multiple of Alignment.
+		uint64_t size;
+	};
+
+	// Strings block payload: `count` entries, each followed by `length` characters and padded to Alignment.
+	struct StringEntry {
+		uint32_t symbol;
+		uint32_t length;
+	};
+
+	// Records block payload: `count` Records, then the data they refer to.
+	struct Record {
+		// Nanoseconds since the capture started.
+		uint64_t timestamp;
+		uint64_t entityId;
+		uint32_t frame;
+		uint32_t pinId;
+		uint32_t pinName;
+		uint32_t entityType;
+		uint32_t entityName;
+		uint32_t dataType;
+		// Offset of the record's data text from the end of the block's record array.
+		uint32_t dataOffset;
+		uint32_t dataSize;
+	};
+
+	// Index block payload: the offset of the previous Index block (0 for the first one), then `count` entries.
+	struct IndexEntry {
+		// Offset of the Strings block defining the names the Records block first uses, or of the Records block
+		// itself if it doesn't use any new names.
+		uint64_t blockOffset;
+		uint64_t firstTimestamp;
+		uint64_t lastTimestamp;
+		uint32_t firstFrame;
+		uint32_t recordCount;
+	};
+
+	struct Footer {
+		uint64_t lastIndexOffset;
+		uint64_t recordCount;
+		char magic[8];
+	};
+
+	static_assert(sizeof(FileHeader) == 32);
+	static_assert(sizeof(BlockHeader) == 16);
+	static_assert(sizeof(StringEntry) == 8);
+	static_assert(sizeof(Record) == 48);
+	static_assert(sizeof(IndexEntry) == 32);
+	static_assert(sizeof(Footer) == 24);
+}
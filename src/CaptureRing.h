@@ -0,0 +1,95 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+// Bounded multi-producer, single-consumer ring used to hand raw pin records from the hook to the decoder.
+// PinCapture only pushes from the game thread, the producer side just doesn't rely on that.
+// Producers never block or allocate; when the ring is full the record is dropped and counted instead.
+// Has no SDK dependencies so it can be driven with synthetic records outside of the game.
+template <typename T, size_t Capacity>
+class CaptureRing {
+	static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "CaptureRing capacity must be a power of two");
+
+public:
+	CaptureRing() {
+		for (size_t i = 0; i < Capacity; ++i)
+			cells[i].sequence.store(i, std::memory_order_relaxed);
+	}
+
+	CaptureRing(const CaptureRing&) = delete;
+	CaptureRing& operator=(const CaptureRing&) = delete;
+
+	// Claims a slot and lets `fill` construct the record in place. Returns false if the ring was full.
+	template <typename F>
+	auto TryPush(F&& fill) -> bool {
+		auto pos = enqueuePos.load(std::memory_order_relaxed);
+		Cell* cell;
+
+		for (;;) {
+			cell = &cells[pos & (Capacity - 1)];
+			const auto seq = cell->sequence.load(std::memory_order_acquire);
+			const auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+
+			if (diff == 0) {
+				if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+					break;
+			}
+			else if (diff < 0) {
+				dropped.fetch_add(1, std::memory_order_relaxed);
+				return false;
+			}
+			else pos = enqueuePos.load(std::memory_order_relaxed);
+		}
+
+		fill(cell->value);
+		cell->sequence.store(pos + 1, std::memory_order_release);
+		pushed.fetch_add(1, std::memory_order_relaxed);
+		return true;
+	}
+
+	// Hands up to `maxCount` published records to `consume` in push order. Must only be called from one thread.
+	template <typename F>
+	auto Drain(F&& consume, size_t maxCount = Capacity) -> size_t {
+		size_t count = 0;
+
+		while (count < maxCount) {
+			auto& cell = cells[dequeuePos & (Capacity - 1)];
+			const auto seq = cell.sequence.load(std::memory_order_acquire);
+
+			if (seq != dequeuePos + 1)
+				break;
+
+			consume(cell.value);
+			cell.sequence.store(dequeuePos + Capacity, std::memory_order_release);
+			++dequeuePos;
+			++count;
+		}
+
+		drained.fetch_add(count, std::memory_order_relaxed);
+		return count;
+	}
+
+	auto Pushed() const -> uint64_t { return pushed.load(std::memory_order_relaxed); }
+	auto Dropped() const -> uint64_t { return dropped.load(std::memory_order_relaxed); }
+	auto Drained() const -> uint64_t { return drained.load(std::memory_order_relaxed); }
+
+	static constexpr auto GetCapacity() -> size_t { return Capacity; }
+
+private:
+	static constexpr size_t CacheLine = 64;
+
+	struct alignas(CacheLine) Cell {
+		std::atomic<size_t> sequence;
+		T value;
+	};
+
+	std::array<Cell, Capacity> cells;
+	alignas(CacheLine) std::atomic<size_t> enqueuePos = 0;
+	alignas(CacheLine) size_t dequeuePos = 0;
+	alignas(CacheLine) std::atomic<uint64_t> pushed = 0;
+	std::atomic<uint64_t> dropped = 0;
+	std::atomic<uint64_t> drained = 0;
+};
@@ -0,0 +1,208 @@
+#include "CaptureWriter.h"
+#include <cstring>
+
+using namespace CaptureFormat;
+
+auto CaptureWriter::Open(const std::filesystem::path& filePath) -> bool {
+	this->Close();
+	if (thread.joinable()) thread.join();
+
+#ifdef _WIN32
+	file = _wfopen(filePath.c_str(), L"wb");
+#else
+	file = std::fopen(filePath.c_str(), "wb");
+#endif
+
+	if (!file) return false;
+
+	path = filePath;
+	startTime = Clock::now();
+	stopping = false;
+	pending.Clear();
+	writtenSymbols.clear();
+	index.clear();
+	fileOffset = 0;
+	lastIndexOffset = 0;
+	recordCount = 0;
+	droppedCount = 0;
+	bytesWritten = 0;
+	failed = false;
+
+	FileHeader header{};
+	std::memcpy(header.magic, Magic, sizeof(Magic));
+	header.version = Version;
+	header.headerSize = sizeof(FileHeader);
+	header.startTime = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+	this->Write(&header, sizeof(header));
+
+	if (failed) {
+		std::fclose(file);
+		file = nullptr;
+		return false;
+	}
+
+	open = true;
+	thread = std::thread(&CaptureWriter::WriterLoop, this);
+	return true;
+}
+
+auto CaptureWriter::Close() -> void {
+	if (!open) return;
+
+	{
+		auto guard = std::scoped_lock(lock);
+		stopping = true;
+	}
+
+	open = false;
+	wake.notify_one();
+}
+
+auto CaptureWriter::Finish() -> void {
+	this->WriteIndex();
+
+	Footer footer{};
+	footer.lastIndexOffset = lastIndexOffset;
+	footer.recordCount = recordCount;
+	std::memcpy(footer.magic, FooterMagic, sizeof(FooterMagic));
+	this->Write(&footer, sizeof(footer));
+
+	if (std::fclose(file) != 0)
+		failed = true;
+	file = nullptr;
+}
+
+auto CaptureWriter::AddSymbol(Symbol symbol) -> void {
+	if (symbol == 0) return;
+	if (symbol >= writtenSymbols.size()) writtenSymbols.resize(symbol + 1);
+	if (writtenSymbols[symbol]) return;
+
+	writtenSymbols[symbol] = true;
+
+	const auto str = SymbolView(symbol);
+	pending.strings.push_back({ symbol, static_cast<uint32_t>(str.size()) });
+	pending.stringData.append(str);
+}
+
+auto CaptureWriter::Append(Record record, std::string_view data) -> void {
+	if (!open || failed.load(std::memory_order_relaxed)) return;
+
+	auto guard = std::scoped_lock(lock);
+
+	if (pending.Bytes() + sizeof(Record) + data.size() > MaxPendingBytes) {
+		droppedCount.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	this->AddSymbol(record.pinName);
+	this->AddSymbol(record.entityType);
+	this->AddSymbol(record.entityName);
+	this->AddSymbol(record.dataType);
+
+	record.dataOffset = static_cast<uint32_t>(pending.data.size());
+	record.dataSize = static_cast<uint32_t>(data.size());
+	pending.records.push_back(record);
+	pending.data.append(data);
+
+	if (pending.records.size() == FlushRecords)
+		wake.notify_one();
+}
+
+auto CaptureWriter::WriterLoop() -> void {
+	Batch batch;
+
+	for (;;) {
+		{
+			auto guard = std::unique_lock(lock);
+			wake.wait_for(guard, std::chrono::milliseconds(100), [this] {
+				return stopping || pending.records.size() >= FlushRecords;
+			});
+
+			std::swap(batch, pending);
+			if (batch.Empty() && stopping) break;
+		}
+
+		this->WriteBatch(batch);
+		batch.Clear();
+	}
+
+	this->Finish();
+}
+
+auto CaptureWriter::WriteBatch(const Batch& batch) -> void {
+	const auto blockOffset = fileOffset;
+
+	if (!batch.strings.empty()) {
+		uint64_t size = 0;
+		for (auto& entry : batch.strings)
+			size += sizeof(StringEntry) + AlignUp(entry.length);
+
+		BlockHeader header{ BlockType::Strings, static_cast<uint32_t>(batch.strings.size()), size };
+		this->Write(&header, sizeof(header));
+
+		size_t offset = 0;
+		for (auto& entry : batch.strings) {
+			this->Write(&entry, sizeof(entry));
+			this->Write(batch.stringData.data() + offset, entry.length);
+			this->Pad();
+			offset += entry.length;
+		}
+	}
+
+	if (!batch.records.empty()) {
+		const auto recordBytes = batch.records.size() * sizeof(Record);
+
+		BlockHeader header{ BlockType::Records, static_cast<uint32_t>(batch.records.size()), AlignUp(recordBytes + batch.data.size()) };
+		this->Write(&header, sizeof(header));
+		this->Write(batch.records.data(), recordBytes);
+		this->Write(batch.data.data(), batch.data.size());
+		this->Pad();
+
+		index.push_back({
+			blockOffset,
+			batch.records.front().timestamp,
+			batch.records.back().timestamp,
+			batch.records.front().frame,
+			static_cast<uint32_t>(batch.records.size()),
+		});
+
+		recordCount.fetch_add(batch.records.size(), std::memory_order_relaxed);
+
+		if (index.size() == IndexInterval)
+			this->WriteIndex();
+	}
+
+	if (std::fflush(file) != 0)
+		failed = true;
+}
+
+auto CaptureWriter::WriteIndex() -> void {
+	if (index.empty()) return;
+
+	const auto offset = fileOffset;
+
+	BlockHeader header{ BlockType::Index, static_cast<uint32_t>(index.size()), sizeof(uint64_t) + index.size() * sizeof(IndexEntry) };
+	this->Write(&header, sizeof(header));
+	this->Write(&lastIndexOffset, sizeof(lastIndexOffset));
+	this->Write(index.data(), index.size() * sizeof(IndexEntry));
+
+	lastIndexOffset = offset;
+	index.clear();
+}
+
+auto CaptureWriter::Write(const void* data, size_t size) -> void {
+	if (size == 0 || failed.load(std::memory_order_relaxed)) return;
+
+	if (std::fwrite(data, 1, size, file) != size) {
+		failed = true;
+		return;
+	}
+
+	fileOffset += size;
+	bytesWritten.store(fileOffset, std::memory_order_relaxed);
+}
+
+auto CaptureWriter::Pad() -> void {
+	static constexpr char s_Zeroes[Alignment] = {};
+	this->Write(s_Zeroes, AlignUp(fileOffset) - fileOffset);
+}
@@ -0,0 +1,115 @@
+#pragma once
+#include "CaptureFormat.h"
+#include "StringInterner.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// Appends accepted pin calls to a capture file (see CaptureFormat.h).
+// The game thread only copies records into an in-memory batch. A background thread swaps the batch out
+// and does all of the file I/O, including the footer on close, so a slow disk costs dropped records rather
+// than frames. Once a write fails nothing more is written, and the file is left as a capture cut short.
+class CaptureWriter {
+public:
+	using Clock = std::chrono::steady_clock;
+
+	static constexpr size_t MaxPendingBytes = 64 * 1024 * 1024;
+	static constexpr size_t FlushRecords = 4096;
+	static constexpr size_t IndexInterval = 64;
+
+	CaptureWriter() = default;
+	CaptureWriter(const CaptureWriter&) = delete;
+	CaptureWriter& operator=(const CaptureWriter&) = delete;
+
+	~CaptureWriter() {
+		this->Close();
+		if (thread.joinable()) thread.join();
+	}
+
+	// Waits for the previous capture to finish closing, if it hasn't yet.
+	auto Open(const std::filesystem::path& path) -> bool;
+	// Has the writer thread flush everything that was appended and write the footer, without waiting for it.
+	auto Close() -> void;
+
+	// Symbols referenced by the record are written to the file the first time they are seen.
+	auto Append(CaptureFormat::Record record, std::string_view data) -> void;
+
+	// Calls captured before the file was opened are recorded at its start.
+	auto TimestampFor(Clock::time_point time) const -> uint64_t {
+		if (time <= startTime) return 0;
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(time - startTime).count());
+	}
+
+	auto IsOpen() const -> bool { return open.load(std::memory_order_relaxed); }
+	// True if writing to the file failed, after which the rest of the capture is discarded.
+	auto Failed() const -> bool { return failed.load(std::memory_order_relaxed); }
+	auto GetPath() const -> const std::filesystem::path& { return path; }
+	auto RecordCount() const -> uint64_t { return recordCount.load(std::memory_order_relaxed); }
+	auto DroppedCount() const -> uint64_t { return droppedCount.load(std::memory_order_relaxed); }
+	auto BytesWritten() const -> uint64_t { return bytesWritten.load(std::memory_order_relaxed); }
+
+private:
+	struct Batch {
+		std::vector<CaptureFormat::Record> records;
+		std::string data;
+		std::vector<CaptureFormat::StringEntry> strings;
+		std::string stringData;
+
+		auto Bytes() const -> size_t {
+			return records.size() * sizeof(CaptureFormat::Record) + data.size() + stringData.size();
+		}
+
+		auto Empty() const -> bool {
+			return records.empty() && strings.empty();
+		}
+
+		auto Clear() -> void {
+			records.clear();
+			data.clear();
+			strings.clear();
+			stringData.clear();
+		}
+	};
+
+	auto AddSymbol(Symbol symbol) -> void;
+	auto WriterLoop() -> void;
+	// Writes the last index and the footer and closes the file.
+	auto Finish() -> void;
+	auto WriteBatch(const Batch& batch) -> void;
+	auto WriteIndex() -> void;
+	auto Write(const void* data, size_t size) -> void;
+	auto Pad() -> void;
+
+	std::FILE* file = nullptr;
+	std::filesystem::path path;
+	Clock::time_point startTime;
+	std::thread thread;
+
+	std::atomic<bool> open = false;
+	std::atomic<bool> failed = false;
+
+	// Shared between the game thread and the writer thread.
+	std::mutex lock;
+	std::condition_variable wake;
+	Batch pending;
+	bool stopping = false;
+
+	// Game thread only.
+	std::vector<bool> writtenSymbols;
+
+	// Writer thread only, apart from the header written before the thread starts.
+	std::vector<CaptureFormat::IndexEntry> index;
+	uint64_t fileOffset = 0;
+	uint64_t lastIndexOffset = 0;
+
+	std::atomic<uint64_t> recordCount = 0;
+	std::atomic<uint64_t> droppedCount = 0;
+	std::atomic<uint64_t> bytesWritten = 0;
+};
@@ -0,0 +1,67 @@
+#include "EntityLayoutCache.h"
+#include <ResourceLib_HM3.h>
+#include <algorithm>
+#include <format>
+
+auto EntityLayoutCache::Get(ZEntityType* entityType) -> std::shared_ptr<const EntityLayout> {
+	if (!entityType || !entityType->m_pProperties01)
+		return nullptr;
+
+	const auto* s_Properties = entityType->m_pProperties01;
+	auto [layout, inserted] = layouts.TryEmplace(s_Properties);
+
+	if (inserted || (*layout)->tableSize != s_Properties->size())
+		*layout = Build(*s_Properties);
+
+	return *layout;
+}
+
+auto EntityLayoutCache::Build(const TArray<ZEntityProperty>& properties) -> std::shared_ptr<const EntityLayout> {
+	auto layout = std::make_shared<EntityLayout>();
+	layout->tableSize = properties.size();
+	layout->properties.reserve(properties.size());
+
+	for (uint32_t i = 0; i < properties.size(); ++i) {
+		ZEntityProperty* s_Property = &properties[i];
+		if (!s_Property->m_pType)
+			continue;
+
+		auto* s_PropertyInfo = s_Property->m_pType->getPropertyInfo();
+
+		if (!s_PropertyInfo || !s_PropertyInfo->m_pType)
+			continue;
+
+		const auto s_TypeInfo = s_PropertyInfo->m_pType->typeInfo();
+
+		PropertyLayout prop;
+		prop.info = s_PropertyInfo;
+		prop.type = s_PropertyInfo->m_pType;
+		prop.decoder = PropertyDecoders::Resolve(prop.type);
+		prop.inputId = Intern(std::format("##Property{}", i));
+		prop.entityOffset = s_Property->m_nOffset;
+		prop.index = i;
+		prop.propertyId = s_Property->m_nPropertyId;
+		prop.size = s_TypeInfo->m_nTypeSize;
+		prop.alignment = std::max<uint16>(s_TypeInfo->m_nTypeAlignment, 1);
+		prop.useGetter = (s_PropertyInfo->m_nFlags & EPropertyInfoFlags::E_HAS_GETTER_SETTER) != 0;
+		prop.compared = prop.decoder.trivial && prop.alignment <= alignof(std::max_align_t);
+		prop.hasNoDirectName = s_TypeInfo->isResource() || s_PropertyInfo->m_nPropertyID != s_Property->m_nPropertyId;
+
+		if (prop.hasNoDirectName) {
+			const auto s_PropertyName = HM3_GetPropertyName(s_Property->m_nPropertyId);
+
+			prop.name = s_PropertyName.Size > 0
+				? Intern(std::string_view(s_PropertyName.Data, s_PropertyName.Size))
+				: Intern(std::format("~{:#08x}", s_Property->m_nPropertyId));
+		}
+		else prop.name = Intern(s_PropertyInfo->m_pName);
+
+		prop.storageOffset = (layout->storageSize + prop.alignment - 1) & ~size_t(prop.alignment - 1);
+		layout->storageSize = prop.storageOffset + prop.size;
+		layout->storageAlignment = std::max<size_t>(layout->storageAlignment, prop.alignment);
+		layout->trivial = layout->trivial && prop.decoder.trivial;
+		layout->properties.push_back(std::move(prop));
+	}
+
+	return layout;
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include "FlatHashMap.h"
+#include "PropertyDecoders.h"
+#include "StringInterner.h"
+#include <Glacier/ZEntity.h>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// Everything about a property that is the same for every entity sharing a property table.
+struct PropertyLayout {
+	ZClassProperty* info = nullptr;
+	STypeID* type = nullptr;
+	PropertyDecoder decoder;
+	Symbol name = 0;
+	Symbol inputId = 0;
+	size_t entityOffset = 0;
+	size_t storageOffset = 0;
+	uint32 index = 0;
+	uint32 propertyId = 0;
+	uint16 size = 0;
+	uint16 alignment = 1;
+	bool useGetter = false;
+	bool hasNoDirectName = false;
+	// Plain data compared against the entity's previous capture, so deltas only store it when it changed.
+	// Other supported values are stored in every capture and unsupported ones only in keyframes.
+	bool compared = false;
+};
+
+// Precomputed capture layout for an entity type, including where each value goes in a snapshot buffer.
+struct EntityLayout {
+	std::vector<PropertyLayout> properties;
+	// Size of the source table, used to spot a different table reusing a cached address.
+	size_t tableSize = 0;
+	size_t storageSize = 0;
+	size_t storageAlignment = alignof(std::max_align_t);
+	// Every value is plain data, so snapshots have nothing to destruct.
+	bool trivial = true;
+};
+
+// Caches EntityLayouts by property table so capture becomes a straight loop over precomputed entries.
+// Entries must be dropped with Clear() whenever the scene changes as the tables belong to the loaded scene.
+class EntityLayoutCache {
+public:
+	auto Get(ZEntityType* entityType) -> std::shared_ptr<const EntityLayout>;
+
+	auto Clear() -> void {
+		layouts.Clear();
+	}
+
+	auto Size() const -> size_t {
+		return layouts.Size();
+	}
+
+private:
+	static auto Build(const TArray<ZEntityProperty>& properties) -> std::shared_ptr<const EntityLayout>;
+
+	FlatHashMap<const TArray<ZEntityProperty>*, std::shared_ptr<const EntityLayout>> layouts;
+};
@@ -0,0 +1,40 @@
+#include "EntityTreeCache.h"
+#include "MemoryUsage.h"
+
+static constexpr size_t NodeBytes = sizeof(EntityTreeNode) + SharedControlBlockBytes;
+
+auto EntityTreeCache::Get(ZEntityRef entity) -> std::shared_ptr<const EntityTreeNode> {
+	if (!entity) return nullptr;
+
+	const auto s_Type = entity->GetType();
+	const auto s_EntityId = s_Type ? s_Type->m_nEntityId : 0;
+
+	if (auto cached = nodes.Find(entity.m_pEntity); cached && (*cached)->entityId == s_EntityId)
+		return *cached;
+
+	auto s_Parent = entity.GetLogicalParent();
+	auto node = std::make_shared<EntityTreeNode>();
+	node->parent = s_Parent ? this->Get(s_Parent) : nullptr;
+	node->entityId = s_EntityId;
+	node->depth = node->parent ? node->parent->depth + 1 : 0;
+
+	node->typeId = GetEntityInterfaceType(s_Type);
+	node->name = node->typeId ? Intern(node->typeId->typeInfo()->m_pTypeName) : Intern("???");
+
+	if (nodes.Size() >= EntityLimit)
+		nodes.Clear();
+
+	nodes[entity.m_pEntity] = node;
+	this->UpdateStats();
+	return node;
+}
+
+auto EntityTreeCache::Clear() -> void {
+	nodes.Clear();
+	this->UpdateStats();
+}
+
+auto EntityTreeCache::UpdateStats() -> void {
+	entityCount.store(nodes.Size(), std::memory_order_relaxed);
+	memoryUsage.store(nodes.Size() * NodeBytes + nodes.MemoryUsage(), std::memory_order_relaxed);
+}
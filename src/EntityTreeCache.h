@@ -0,0 +1,52 @@
+#pragma once
+#include "FlatHashMap.h"
+#include "StringInterner.h"
+#include <Glacier/ZEntity.h>
+#include <atomic>
+#include <memory>
+
+// Type of the entity's primary interface, which is what the UI calls the entity type.
+inline auto GetEntityInterfaceType(const ZEntityType* entityType) -> STypeID* {
+	if (!entityType || !entityType->m_pInterfaces || entityType->m_pInterfaces->size() == 0)
+		return nullptr;
+	return (*entityType->m_pInterfaces)[0].m_pTypeId;
+}
+
+// Immutable node of an entity's logical ancestry. Siblings share their parent chain.
+struct EntityTreeNode {
+	std::shared_ptr<const EntityTreeNode> parent;
+	STypeID* typeId = nullptr;
+	uint64 entityId = 0;
+	uint32 depth = 0;
+	Symbol name = 0;
+};
+
+// Memoizes entity ancestry by entity pointer so each ancestor is only resolved and formatted once.
+// Nodes are checked against the entity's current ID before being reused and the whole cache is
+// dropped with Clear() when the scene changes.
+class EntityTreeCache {
+public:
+	// Like the property histories, the cache is emptied rather than trimmed once it holds this many entities.
+	// Calls keep the nodes they refer to, though MemoryUsage() no longer counts them, and only entities that
+	// are captured again are resolved anew.
+	static constexpr size_t EntityLimit = 16384;
+
+	auto Get(ZEntityRef entity) -> std::shared_ptr<const EntityTreeNode>;
+	auto Clear() -> void;
+
+	auto Size() const -> size_t {
+		return entityCount.load(std::memory_order_relaxed);
+	}
+
+	// Approximate bytes held by the cache, safe to read from the UI thread.
+	auto MemoryUsage() const -> size_t {
+		return memoryUsage.load(std::memory_order_relaxed);
+	}
+
+private:
+	auto UpdateStats() -> void;
+
+	FlatHashMap<ZEntityType**, std::shared_ptr<const EntityTreeNode>> nodes;
+	std::atomic<size_t> entityCount = 0;
+	std::atomic<size_t> memoryUsage = 0;
+};
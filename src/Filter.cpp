@@ -0,0 +1,80 @@
+#include "Filter.h"
+#include <algorithm>
+
+static auto ToLower(char c) -> char {
+	return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+// Iterative glob match with single-star backtracking, `pattern` is already lowercase.
+static auto GlobMatch(std::string_view pattern, std::string_view name) -> bool {
+	size_t p = 0, n = 0;
+	size_t starP = std::string_view::npos, starN = 0;
+
+	while (n < name.size()) {
+		if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == ToLower(name[n]))) {
+			++p;
+			++n;
+		}
+		else if (p < pattern.size() && pattern[p] == '*') {
+			starP = p++;
+			starN = n;
+		}
+		else if (starP != std::string_view::npos) {
+			p = starP + 1;
+			n = ++starN;
+		}
+		else return false;
+	}
+
+	while (p < pattern.size() && pattern[p] == '*')
+		++p;
+
+	return p == pattern.size();
+}
+
+FilterQuery::FilterQuery(std::string_view text) {
+	if (text.empty()) return;
+
+	if (text.starts_with("re:")) {
+		mode = Mode::Regex;
+		pattern = text.substr(3);
+
+		try {
+			regex = std::regex(pattern, std::regex::ECMAScript | std::regex::icase | std::regex::optimize);
+		}
+		catch (const std::regex_error&) {
+			valid = false;
+		}
+		return;
+	}
+
+	mode = text.find_first_of("*?") != std::string_view::npos ? Mode::Glob : Mode::Substring;
+	pattern.resize(text.size());
+	std::transform(text.begin(), text.end(), pattern.begin(), ToLower);
+}
+
+auto FilterQuery::Matches(std::string_view name) const -> bool {
+	switch (mode) {
+	case Mode::All:
+		return true;
+	case Mode::Substring:
+		return std::search(name.begin(), name.end(), pattern.begin(), pattern.end(), [](char a, char b) {
+			return ToLower(a) == b;
+		}) != name.end();
+	case Mode::Glob:
+		return GlobMatch(pattern, name);
+	case Mode::Regex:
+		// An invalid expression filters nothing out rather than hiding every pin.
+		return !valid || std::regex_search(name.begin(), name.end(), regex);
+	}
+	return true;
+}
+
+auto SymbolFilter::SetQuery(std::string_view newText) -> bool {
+	if (newText == text) return false;
+
+	text = newText;
+	query = FilterQuery(text);
+	results.clear();
+	return true;
+}
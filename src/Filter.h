@@ -0,0 +1,67 @@
+#pragma once
+#include "StringInterner.h"
+#include <cstdint>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Case-insensitive text query compiled once and then matched against many names.
+// "re:" prefixes a regular expression, text containing '*' or '?' is a glob over the whole name,
+// anything else matches as a substring. An empty query matches everything.
+class FilterQuery {
+public:
+	enum class Mode : uint8_t {
+		All,
+		Substring,
+		Glob,
+		Regex,
+	};
+
+	FilterQuery() = default;
+	explicit FilterQuery(std::string_view text);
+
+	auto Matches(std::string_view name) const -> bool;
+
+	auto GetMode() const -> Mode { return mode; }
+	auto IsValid() const -> bool { return valid; }
+	auto MatchesAll() const -> bool { return mode == Mode::All; }
+
+private:
+	std::string pattern;
+	std::regex regex;
+	Mode mode = Mode::All;
+	bool valid = true;
+};
+
+// FilterQuery with the result cached per interned name, so each name is only tested once per query.
+class SymbolFilter {
+public:
+	// Returns false if the query is the same as the current one and nothing was recompiled.
+	auto SetQuery(std::string_view text) -> bool;
+
+	auto Matches(Symbol symbol) -> bool {
+		if (query.MatchesAll()) return true;
+		if (symbol >= results.size()) results.resize(symbol + 1, Result::Unknown);
+
+		auto& result = results[symbol];
+		if (result == Result::Unknown)
+			result = query.Matches(SymbolView(symbol)) ? Result::Match : Result::NoMatch;
+		return result == Result::Match;
+	}
+
+	auto MatchesAll() const -> bool { return query.MatchesAll(); }
+	auto IsValid() const -> bool { return query.IsValid(); }
+	auto GetQuery() const -> std::string_view { return text; }
+
+private:
+	enum class Result : uint8_t {
+		Unknown,
+		NoMatch,
+		Match,
+	};
+
+	FilterQuery query;
+	std::string text;
+	std::vector<Result> results;
+};
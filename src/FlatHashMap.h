@@ -0,0 +1,211 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Default hash for FlatHashMap: a cheap finalizer that works well for pointers and already well-distributed ids.
+template <typename K>
+struct FlatHash {
+	auto operator()(const K& key) const -> size_t {
+		if constexpr (std::is_pointer_v<K>)
+			return Mix(reinterpret_cast<uintptr_t>(key));
+		else if constexpr (std::is_enum_v<K>)
+			return Mix(static_cast<uint64_t>(key));
+		else if constexpr (std::is_integral_v<K>)
+			return Mix(static_cast<uint64_t>(key));
+		else
+			return std::hash<K>{}(key);
+	}
+
+	static constexpr auto Mix(uint64_t x) -> size_t {
+		x ^= x >> 33;
+		x *= 0xff51afd7ed558ccdull;
+		x ^= x >> 33;
+		x *= 0xc4ceb9fe1a85ec53ull;
+		x ^= x >> 33;
+		return static_cast<size_t>(x);
+	}
+};
+
+template <typename A, typename B>
+struct FlatHash<std::pair<A, B>> {
+	auto operator()(const std::pair<A, B>& key) const -> size_t {
+		return FlatHash<uint64_t>::Mix(FlatHash<A>{}(key.first) * 31 + FlatHash<B>{}(key.second));
+	}
+};
+
+// Open-addressed hash map with linear probing and backward-shift deletion.
+// Lookups touch a single contiguous array and erasing never leaves tombstones behind.
+template <typename K, typename V, typename Hash = FlatHash<K>>
+class FlatHashMap {
+public:
+	struct Slot {
+		K key{};
+		V value{};
+		bool used = false;
+	};
+
+	FlatHashMap() = default;
+
+	explicit FlatHashMap(size_t capacity) {
+		Reserve(capacity);
+	}
+
+	auto Find(const K& key) -> V* {
+		if (count == 0) return nullptr;
+
+		for (auto i = IndexFor(key);; i = (i + 1) & mask) {
+			auto& slot = slots[i];
+			if (!slot.used) return nullptr;
+			if (slot.key == key) return &slot.value;
+		}
+	}
+
+	auto Find(const K& key) const -> const V* {
+		return const_cast<FlatHashMap*>(this)->Find(key);
+	}
+
+	auto Contains(const K& key) const -> bool {
+		return Find(key) != nullptr;
+	}
+
+	// Returns the value for `key`, default-constructing it if missing. The bool is true if it was inserted.
+	auto TryEmplace(const K& key) -> std::pair<V*, bool> {
+		if ((count + 1) * 4 > slots.size() * 3)
+			Grow();
+
+		for (auto i = IndexFor(key);; i = (i + 1) & mask) {
+			auto& slot = slots[i];
+
+			if (!slot.used) {
+				slot.key = key;
+				slot.value = V{};
+				slot.used = true;
+				++count;
+				return {&slot.value, true};
+			}
+
+			if (slot.key == key)
+				return {&slot.value, false};
+		}
+	}
+
+	auto Insert(const K& key, V value) -> V* {
+		auto [ptr, inserted] = TryEmplace(key);
+		*ptr = std::move(value);
+		return ptr;
+	}
+
+	auto operator[](const K& key) -> V& {
+		return *TryEmplace(key).first;
+	}
+
+	auto Erase(const K& key) -> bool {
+		if (count == 0) return false;
+
+		auto i = IndexFor(key);
+
+		for (;; i = (i + 1) & mask) {
+			if (!slots[i].used) return false;
+			if (slots[i].key == key) break;
+		}
+
+		// Shift following entries of the same probe chain back into the hole.
+		for (auto j = (i + 1) & mask;; j = (j + 1) & mask) {
+			if (!slots[j].used) break;
+
+			const auto home = IndexFor(slots[j].key);
+			const auto distHole = (i - home) & mask;
+			const auto distCur = (j - home) & mask;
+
+			if (distHole < distCur) {
+				slots[i] = std::move(slots[j]);
+				i = j;
+			}
+		}
+
+		slots[i] = Slot{};
+		--count;
+		return true;
+	}
+
+	template <typename F>
+	auto ForEach(F&& fn) -> void {
+		for (auto& slot : slots)
+			if (slot.used) fn(slot.key, slot.value);
+	}
+
+	template <typename F>
+	auto ForEach(F&& fn) const -> void {
+		for (auto& slot : slots)
+			if (slot.used) fn(slot.key, slot.value);
+	}
+
+	auto Reserve(size_t capacity) -> void {
+		const auto wanted = std::bit_ceil(std::max<size_t>(16, capacity + capacity / 3 + 1));
+		if (wanted > slots.size())
+			Rehash(wanted);
+	}
+
+	auto Clear() -> void {
+		for (auto& slot : slots)
+			slot = Slot{};
+		count = 0;
+	}
+
+	auto Size() const -> size_t { return count; }
+	auto Empty() const -> bool { return count == 0; }
+	auto Capacity() const -> size_t { return slots.size(); }
+	auto MemoryUsage() const -> size_t { return slots.capacity() * sizeof(Slot); }
+
+private:
+	auto IndexFor(const K& key) const -> size_t {
+		return Hash{}(key) & mask;
+	}
+
+	auto Grow() -> void {
+		Rehash(slots.empty() ? 16 : slots.size() * 2);
+	}
+
+	auto Rehash(size_t newSize) -> void {
+		auto old = std::move(slots);
+		slots.clear();
+		slots.resize(newSize);
+		mask = newSize - 1;
+		count = 0;
+
+		for (auto& slot : old) {
+			if (!slot.used) continue;
+			*TryEmplace(slot.key).first = std::move(slot.value);
+		}
+	}
+
+	std::vector<Slot> slots;
+	size_t mask = 0;
+	size_t count = 0;
+};
+
+template <typename K, typename Hash = FlatHash<K>>
+class FlatHashSet {
+public:
+	auto Insert(const K& key) -> bool { return map.TryEmplace(key).second; }
+	auto Erase(const K& key) -> bool { return map.Erase(key); }
+	auto Contains(const K& key) const -> bool { return map.Contains(key); }
+	auto Clear() -> void { map.Clear(); }
+	auto Size() const -> size_t { return map.Size(); }
+	auto Empty() const -> bool { return map.Empty(); }
+
+	template <typename F>
+	auto ForEach(F&& fn) const -> void {
+		map.ForEach([&](const K& key, const Unit&) { fn(key); });
+	}
+
+private:
+	struct Unit {};
+	FlatHashMap<K, Unit, Hash> map;
+};
@@ -0,0 +1,165 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Newest-first circular buffer with a runtime capacity.
+// Slots are constructed once and then overwritten in place, so anything they own (string and vector
+// capacity) is reused by later entries instead of being freed and allocated again.
+template <typename T>
+class HistoryRing {
+public:
+	template <bool Const>
+	class Iterator {
+		using Ring = std::conditional_t<Const, const HistoryRing, HistoryRing>;
+
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = T;
+		using difference_type = std::ptrdiff_t;
+		using pointer = std::conditional_t<Const, const T*, T*>;
+		using reference = std::conditional_t<Const, const T&, T&>;
+
+		Iterator() = default;
+		Iterator(Ring* ring, size_t index) : ring(ring), index(index) {}
+
+		auto operator*() const -> reference { return (*ring)[index]; }
+		auto operator->() const -> pointer { return &(*ring)[index]; }
+		auto operator++() -> Iterator& { ++index; return *this; }
+		auto operator++(int) -> Iterator { auto tmp = *this; ++index; return tmp; }
+		auto operator==(const Iterator& other) const -> bool { return index == other.index; }
+
+	private:
+		Ring* ring = nullptr;
+		size_t index = 0;
+	};
+
+	using iterator = Iterator<false>;
+	using const_iterator = Iterator<true>;
+
+	HistoryRing() = default;
+	explicit HistoryRing(size_t capacity) : capacity(std::max<size_t>(capacity, 1)) {}
+
+	// Copies only hold the live entries.
+	HistoryRing(const HistoryRing& other) : capacity(other.capacity), count(other.count) {
+		slots.reserve(other.count);
+		for (size_t i = 0; i < other.count; ++i)
+			slots.push_back(other[i]);
+	}
+
+	HistoryRing& operator=(const HistoryRing& other) {
+		if (this != &other) {
+			HistoryRing copy(other);
+			*this = std::move(copy);
+		}
+		return *this;
+	}
+
+	// A moved-from ring is left empty, as its slots went with the move.
+	HistoryRing(HistoryRing&& other) noexcept
+		: slots(std::move(other.slots)), capacity(other.capacity), head(std::exchange(other.head, 0)), count(std::exchange(other.count, 0)) {
+		other.slots.clear();
+	}
+
+	HistoryRing& operator=(HistoryRing&& other) noexcept {
+		if (this != &other) {
+			slots = std::move(other.slots);
+			capacity = other.capacity;
+			head = std::exchange(other.head, 0);
+			count = std::exchange(other.count, 0);
+			other.slots.clear();
+		}
+		return *this;
+	}
+
+	// Makes room for a new newest entry and returns its slot. When full, this is the slot of the
+	// oldest entry, still holding its old contents for the caller to overwrite.
+	auto PushFront() -> T& {
+		if (count < slots.size()) {
+			// Reuse a slot left behind by EraseIf or Clear.
+			head = (head + slots.size() - 1) % slots.size();
+			++count;
+		}
+		else if (slots.size() < capacity) {
+			this->Linearize();
+			slots.emplace(slots.begin());
+			++count;
+		}
+		else head = (head + slots.size() - 1) % slots.size();
+
+		return slots[head];
+	}
+
+	// Removes matching entries while keeping the remaining ones in order. Removed slots keep their storage.
+	template <typename F>
+	auto EraseIf(F&& pred) -> size_t {
+		this->Linearize();
+
+		size_t kept = 0;
+
+		for (size_t i = 0; i < count; ++i) {
+			if (pred(slots[i])) continue;
+			if (kept != i) std::swap(slots[kept], slots[i]);
+			++kept;
+		}
+
+		const auto erased = count - kept;
+		count = kept;
+		return erased;
+	}
+
+	auto SetCapacity(size_t newCapacity) -> void {
+		newCapacity = std::max<size_t>(newCapacity, 1);
+		this->Linearize();
+
+		if (slots.size() > newCapacity)
+			slots.resize(newCapacity);
+
+		count = std::min(count, newCapacity);
+		capacity = newCapacity;
+	}
+
+	// Removes the oldest entry. Its slot keeps its storage.
+	auto PopBack() -> void {
+		if (count) --count;
+	}
+
+	auto Clear() -> void {
+		count = 0;
+	}
+
+	// Index 0 is the newest entry.
+	auto operator[](size_t index) -> T& { return slots[(head + index) % slots.size()]; }
+	auto operator[](size_t index) const -> const T& { return slots[(head + index) % slots.size()]; }
+
+	auto Front() -> T& { return (*this)[0]; }
+	auto Back() -> T& { return (*this)[count - 1]; }
+
+	auto Size() const -> size_t { return count; }
+	auto Empty() const -> bool { return count == 0; }
+	auto Capacity() const -> size_t { return capacity; }
+	// Bytes held by the slots themselves, not counting anything they point to.
+	auto MemoryUsage() const -> size_t { return slots.capacity() * sizeof(T); }
+
+	auto begin() -> iterator { return iterator(this, 0); }
+	auto end() -> iterator { return iterator(this, count); }
+	auto begin() const -> const_iterator { return const_iterator(this, 0); }
+	auto end() const -> const_iterator { return const_iterator(this, count); }
+
+private:
+	// Rotates the slots so the newest entry is at index 0.
+	auto Linearize() -> void {
+		if (head != 0) {
+			std::rotate(slots.begin(), slots.begin() + head, slots.end());
+			head = 0;
+		}
+	}
+
+	std::vector<T> slots;
+	size_t capacity = 10;
+	size_t head = 0;
+	size_t count = 0;
+};
@@ -0,0 +1,205 @@
+#include "JsonWriter.h"
+#include <charconv>
+#include <cmath>
+
+auto JsonWriter::Clear() -> void {
+	buffer.clear();
+	depth = 0;
+	written = 0;
+	hasValues[0] = false;
+	afterKey = false;
+	truncated = false;
+}
+
+auto JsonWriter::BeginValue() -> bool {
+	if (depth > written)
+		return false;
+
+	if (buffer.size() >= sizeCap) {
+		truncated = true;
+
+		// The key is already out, so it gets a value to keep the document valid.
+		if (afterKey) {
+			buffer += "null";
+			afterKey = false;
+		}
+
+		return false;
+	}
+
+	if (afterKey)
+		afterKey = false;
+	else if (hasValues[written])
+		buffer += ',';
+
+	hasValues[written] = true;
+	return true;
+}
+
+auto JsonWriter::Begin(char open) -> void {
+	if (!this->BeginValue()) {
+		++depth;
+		return;
+	}
+
+	++depth;
+
+	if (written == MaxDepth) {
+		buffer += "null";
+		truncated = true;
+		return;
+	}
+
+	buffer += open;
+	hasValues[++written] = false;
+}
+
+auto JsonWriter::End(char close) -> void {
+	if (depth == 0) return;
+
+	if (depth-- > written)
+		return;
+
+	buffer += close;
+	--written;
+}
+
+auto JsonWriter::BeginObject() -> void {
+	this->Begin('{');
+}
+
+auto JsonWriter::EndObject() -> void {
+	this->End('}');
+}
+
+auto JsonWriter::BeginArray() -> void {
+	this->Begin('[');
+}
+
+auto JsonWriter::EndArray() -> void {
+	this->End(']');
+}
+
+auto JsonWriter::Key(std::string_view key) -> void {
+	// A key that is skipped for the size cap takes its value with it, as the cap is still exceeded then.
+	if (depth > written) return;
+
+	if (buffer.size() >= sizeCap) {
+		truncated = true;
+		return;
+	}
+
+	if (hasValues[written])
+		buffer += ',';
+
+	hasValues[written] = true;
+	this->WriteEscaped(key);
+	buffer += ':';
+	afterKey = true;
+}
+
+auto JsonWriter::String(std::string_view value) -> void {
+	if (!this->BeginValue()) return;
+
+	// Long strings are cut to what's left under the cap, without splitting a UTF-8 sequence.
+	if (const auto s_Room = buffer.size() < sizeCap ? sizeCap - buffer.size() : 0; value.size() > s_Room) {
+		auto length = s_Room;
+		while (length > 0 && (static_cast<unsigned char>(value[length]) & 0xC0) == 0x80)
+			--length;
+
+		value = value.substr(0, length);
+		truncated = true;
+	}
+
+	this->WriteEscaped(value);
+}
+
+auto JsonWriter::Bool(bool value) -> void {
+	if (this->BeginValue())
+		buffer += value ? "true" : "false";
+}
+
+auto JsonWriter::Null() -> void {
+	if (this->BeginValue())
+		buffer += "null";
+}
+
+auto JsonWriter::Int(int64_t value) -> void {
+	if (!this->BeginValue()) return;
+
+	char s_Chars[24];
+	const auto s_Result = std::to_chars(s_Chars, s_Chars + sizeof(s_Chars), value);
+	buffer.append(s_Chars, s_Result.ptr);
+}
+
+auto JsonWriter::Uint(uint64_t value) -> void {
+	if (!this->BeginValue()) return;
+
+	char s_Chars[24];
+	const auto s_Result = std::to_chars(s_Chars, s_Chars + sizeof(s_Chars), value);
+	buffer.append(s_Chars, s_Result.ptr);
+}
+
+auto JsonWriter::Double(double value) -> void {
+	if (!this->BeginValue()) return;
+
+	if (!std::isfinite(value)) {
+		buffer += "null";
+		return;
+	}
+
+	char s_Chars[32];
+	const auto s_Result = std::to_chars(s_Chars, s_Chars + sizeof(s_Chars), value);
+	buffer.append(s_Chars, s_Result.ptr);
+}
+
+auto JsonWriter::Float(float value) -> void {
+	if (!this->BeginValue()) return;
+
+	if (!std::isfinite(value)) {
+		buffer += "null";
+		return;
+	}
+
+	char s_Chars[24];
+	const auto s_Result = std::to_chars(s_Chars, s_Chars + sizeof(s_Chars), value);
+	buffer.append(s_Chars, s_Result.ptr);
+}
+
+auto JsonWriter::Raw(std::string_view json) -> void {
+	if (this->BeginValue())
+		buffer += json;
+}
+
+auto JsonWriter::WriteEscaped(std::string_view str) -> void {
+	static constexpr char s_Hex[] = "0123456789abcdef";
+
+	buffer += '"';
+
+	// Characters that need no escaping are appended in runs.
+	size_t run = 0;
+
+	for (size_t i = 0; i < str.size(); ++i) {
+		const auto c = static_cast<unsigned char>(str[i]);
+		if (c >= 0x20 && c != '"' && c != '\\') continue;
+
+		buffer.append(str.data() + run, i - run);
+		run = i + 1;
+
+		switch (c) {
+		case '"': buffer += "\\\""; break;
+		case '\\': buffer += "\\\\"; break;
+		case '\n': buffer += "\\n"; break;
+		case '\r': buffer += "\\r"; break;
+		case '\t': buffer += "\\t"; break;
+		default:
+			buffer += "\\u00";
+			buffer += s_Hex[c >> 4];
+			buffer += s_Hex[c & 0xF];
+			break;
+		}
+	}
+
+	buffer.append(str.data() + run, str.size() - run);
+	buffer += '"';
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Streaming JSON writer into a buffer that is reused between documents, so once it has grown nothing is
+// allocated. Nesting deeper than MaxDepth is written as null and output stops growing at the size cap,
+// with the document still closed properly in both cases and Truncated() set.
+class JsonWriter {
+public:
+	static constexpr size_t MaxDepth = 32;
+	static constexpr size_t DefaultSizeCap = 64 * 1024;
+
+	explicit JsonWriter(size_t sizeCap = DefaultSizeCap) : sizeCap(sizeCap) {}
+
+	// Starts a new document, keeping the buffer's capacity.
+	auto Clear() -> void;
+
+	auto BeginObject() -> void;
+	auto EndObject() -> void;
+	auto BeginArray() -> void;
+	auto EndArray() -> void;
+	auto Key(std::string_view key) -> void;
+
+	auto String(std::string_view value) -> void;
+	auto Bool(bool value) -> void;
+	auto Null() -> void;
+	auto Int(int64_t value) -> void;
+	auto Uint(uint64_t value) -> void;
+	// Shortest representation that reads back as the same value. NaN and infinities are written as null.
+	auto Double(double value) -> void;
+	auto Float(float value) -> void;
+	// Text that is already valid JSON, written as a single value.
+	auto Raw(std::string_view json) -> void;
+
+	auto View() const -> std::string_view { return buffer; }
+	auto Size() const -> size_t { return buffer.size(); }
+	auto Truncated() const -> bool { return truncated; }
+	// True once values are no longer written, either because of the size cap or because they are nested too deep.
+	auto Skipping() const -> bool { return depth > written || buffer.size() >= sizeCap; }
+	auto SetSizeCap(size_t cap) -> void { sizeCap = cap; }
+
+private:
+	// Writes the separator for a new value and returns false if the value should be skipped.
+	auto BeginValue() -> bool;
+	auto Begin(char open) -> void;
+	auto End(char close) -> void;
+	auto WriteEscaped(std::string_view str) -> void;
+
+	std::string buffer;
+	size_t sizeCap;
+	// Containers opened so far, of which the outermost `written` are in the output and the rest are being skipped.
+	size_t depth = 0;
+	size_t written = 0;
+	std::array<bool, MaxDepth + 1> hasValues{};
+	bool afterKey = false;
+	bool truncated = false;
+};
@@ -0,0 +1,39 @@
+#pragma once
+#include "SlabArena.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Helpers for estimating the heap memory owned by retained data.
+
+// Bytes a string owns on the heap, zero if it fits in the small string buffer.
+inline auto HeapBytes(const std::string& str) -> size_t {
+	const auto* data = str.data();
+	const auto* self = reinterpret_cast<const char*>(&str);
+	return data >= self && data < self + sizeof(str) ? 0 : str.capacity() + 1;
+}
+
+template <typename T>
+inline auto HeapBytes(const std::vector<T>& vec) -> size_t {
+	return vec.capacity() * sizeof(T);
+}
+
+// Heap bytes owned by a value beyond its own size.
+struct OwnedBytes {
+	size_t bytes = 0;
+	// False when some of it couldn't be measured and isn't included in `bytes`.
+	bool measured = true;
+
+	auto operator+=(const OwnedBytes& other) -> OwnedBytes& {
+		bytes += other.bytes;
+		measured = measured && other.measured;
+		return *this;
+	}
+};
+
+// Approximate size of the control block make_shared places in front of the object.
+inline constexpr size_t SharedControlBlockBytes = 2 * sizeof(void*);
+
+// Approximate size of an object and its control block allocated with allocate_shared from the slab arena.
+template <typename T>
+inline constexpr size_t SlabSharedBytes = SlabArena::BlockSize(sizeof(T) + SharedControlBlockBytes, alignof(T));
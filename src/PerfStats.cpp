@@ -0,0 +1,106 @@
+#include "PerfStats.h"
+#include <algorithm>
+
+namespace {
+	struct ClockSample {
+		uint64_t ticks;
+		std::chrono::steady_clock::time_point time;
+
+		static auto Take() -> ClockSample {
+			return { PerfClock::Now(), std::chrono::steady_clock::now() };
+		}
+	};
+
+	const auto s_CalibrationStart = ClockSample::Take();
+}
+
+auto PerfClock::TicksPerSecond() -> double {
+#ifdef PINCUSHION_PERF_TSC
+	const auto s_Now = ClockSample::Take();
+	const auto s_Seconds = std::chrono::duration<double>(s_Now.time - s_CalibrationStart.time).count();
+
+	// Too early to tell, assume a typical TSC frequency rather than dividing by almost nothing.
+	if (s_Seconds < 0.01)
+		return 3e9;
+
+	return static_cast<double>(s_Now.ticks - s_CalibrationStart.ticks) / s_Seconds;
+#else
+	return static_cast<double>(std::chrono::steady_clock::period::den) / std::chrono::steady_clock::period::num;
+#endif
+}
+
+auto LatencyHistogram::Summary::Quantile(double q) const -> uint64_t {
+	if (count == 0) return 0;
+
+	const auto target = static_cast<uint64_t>(q * static_cast<double>(count - 1));
+	uint64_t seen = 0;
+
+	for (size_t i = 0; i < buckets.size(); ++i) {
+		seen += buckets[i];
+		if (seen > target)
+			return std::min(BucketUpperBound(i), max);
+	}
+
+	return max;
+}
+
+auto LatencyHistogram::Summarize() const -> Summary {
+	Summary summary;
+
+	for (size_t i = 0; i < buckets.size(); ++i) {
+		summary.buckets[i] = buckets[i].load(std::memory_order_relaxed);
+		summary.count += summary.buckets[i];
+	}
+
+	summary.sum = sum.load(std::memory_order_relaxed);
+	summary.max = max.load(std::memory_order_relaxed);
+	return summary;
+}
+
+auto LatencyHistogram::Reset() -> void {
+	for (auto& bucket : buckets)
+		bucket.store(0, std::memory_order_relaxed);
+
+	sum.store(0, std::memory_order_relaxed);
+	max.store(0, std::memory_order_relaxed);
+}
+
+auto PerfStats::StageName(PerfStage stage) -> const char* {
+	switch (stage) {
+	case PerfStage::Hook: return "Hook";
+	case PerfStage::HookFilters: return "Hook: filters";
+	case PerfStage::HookEnqueue: return "Hook: enqueue";
+	case PerfStage::DecodePayload: return "Decode: payload";
+	case PerfStage::DecodeEntity: return "Decode: entity name/tree";
+	case PerfStage::DecodeProperties: return "Decode: properties";
+	case PerfStage::DecodeStorage: return "Decode: storage";
+	case PerfStage::DecodeRecord: return "Decode: recording";
+	case PerfStage::FrameActions: return "Frame: actions";
+	case PerfStage::FrameDrain: return "Frame: drain";
+	case PerfStage::FrameRatePrune: return "Frame: rate prune";
+	case PerfStage::FramePublish: return "Frame: publish";
+	case PerfStage::Frame: return "Frame";
+	case PerfStage::HookPerFrame: return "Hook time per frame";
+	case PerfStage::DrawUI: return "Draw UI";
+	case PerfStage::Count: break;
+	}
+
+	return "?";
+}
+
+auto PerfStats::RecordHookFrame() -> void {
+	const auto s_Sum = this->Get(PerfStage::Hook).Sum();
+
+	// The hook histogram may have been reset since the last frame.
+	if (this->IsEnabled() && s_Sum >= lastHookSum)
+		this->Record(PerfStage::HookPerFrame, s_Sum - lastHookSum);
+
+	lastHookSum = s_Sum;
+}
+
+auto PerfStats::Reset() -> void {
+	for (auto& histogram : histograms)
+		histogram.Reset();
+
+	lastHookSum = 0;
+}
@@ -0,0 +1,198 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#define PINCUSHION_PERF_TSC 1
+#endif
+
+// Cheapest monotonic timestamp available, in ticks of unknown length. Uses the TSC on x64.
+namespace PerfClock {
+	inline auto Now() -> uint64_t {
+#ifdef PINCUSHION_PERF_TSC
+		return __rdtsc();
+#else
+		return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+	}
+
+	// Calibrated against steady_clock since the module was loaded, so it gets more precise the longer it runs.
+	auto TicksPerSecond() -> double;
+}
+
+// HDR-style histogram of tick counts: every power of two is split into 8 linear buckets, so any
+// recorded value is known to within 12.5%. Safe to record into from several threads and read from another.
+class LatencyHistogram {
+public:
+	static constexpr size_t SubBucketBits = 3;
+	static constexpr size_t SubBuckets = size_t(1) << SubBucketBits;
+	static constexpr size_t BucketCount = (64 - SubBucketBits + 1) * SubBuckets;
+
+	// Plain copy of the counters, for computing quantiles without racing the recording threads.
+	struct Summary {
+		std::array<uint64_t, BucketCount> buckets{};
+		uint64_t count = 0;
+		uint64_t sum = 0;
+		uint64_t max = 0;
+
+		// Upper bound of the bucket holding the given quantile.
+		auto Quantile(double q) const -> uint64_t;
+		auto Mean() const -> double { return count ? static_cast<double>(sum) / static_cast<double>(count) : 0; }
+	};
+
+	// A weight above 1 lets a sampled value stand in for the unsampled ones around it.
+	auto Record(uint64_t ticks, uint32_t weight = 1) -> void {
+		buckets[BucketFor(ticks)].fetch_add(weight, std::memory_order_relaxed);
+		sum.fetch_add(ticks * weight, std::memory_order_relaxed);
+
+		// Only contended while the maximum is still climbing.
+		auto current = max.load(std::memory_order_relaxed);
+		while (ticks > current && !max.compare_exchange_weak(current, ticks, std::memory_order_relaxed));
+	}
+
+	// Total ticks recorded so far, which callers can diff to get the time spent over an interval.
+	auto Sum() const -> uint64_t { return sum.load(std::memory_order_relaxed); }
+
+	auto Summarize() const -> Summary;
+	auto Reset() -> void;
+
+	static constexpr auto BucketFor(uint64_t value) -> size_t {
+		if (value < SubBuckets)
+			return static_cast<size_t>(value);
+
+		const auto exponent = static_cast<size_t>(std::bit_width(value)) - 1;
+		const auto sub = static_cast<size_t>(value >> (exponent - SubBucketBits)) & (SubBuckets - 1);
+		return (exponent - SubBucketBits + 1) * SubBuckets + sub;
+	}
+
+	// Largest value that falls into the given bucket.
+	static constexpr auto BucketUpperBound(size_t bucket) -> uint64_t {
+		if (bucket < SubBuckets)
+			return bucket;
+
+		const auto exponent = bucket / SubBuckets + SubBucketBits - 1;
+		const auto sub = bucket % SubBuckets;
+		const auto width = uint64_t(1) << (exponent - SubBucketBits);
+		return (uint64_t(1) << exponent) + (sub + 1) * width - 1;
+	}
+
+private:
+	std::array<std::atomic<uint64_t>, BucketCount> buckets{};
+	std::atomic<uint64_t> sum = 0;
+	std::atomic<uint64_t> max = 0;
+};
+
+enum class PerfStage {
+	// Per hook call.
+	Hook,
+	HookFilters,
+	HookEnqueue,
+	// Per decoded call.
+	DecodePayload,
+	DecodeEntity,
+	DecodeProperties,
+	DecodeStorage,
+	DecodeRecord,
+	// Per frame.
+	FrameActions,
+	FrameDrain,
+	FrameRatePrune,
+	FramePublish,
+	Frame,
+	// Total hook time between two frame updates.
+	HookPerFrame,
+	DrawUI,
+	Count,
+};
+
+// Timings of the capture pipeline itself, so its own overhead can be told apart from the game's.
+class PerfStats {
+public:
+	static constexpr size_t StageCount = static_cast<size_t>(PerfStage::Count);
+	// Only one in this many hook calls is timed, as reading the clock costs more than most of the checks being timed.
+	static constexpr uint32_t HookSampleInterval = 16;
+
+	static auto StageName(PerfStage stage) -> const char*;
+
+	auto Record(PerfStage stage, uint64_t ticks, uint32_t weight = 1) -> void {
+		histograms[static_cast<size_t>(stage)].Record(ticks, weight);
+	}
+
+	auto Get(PerfStage stage) const -> const LatencyHistogram& {
+		return histograms[static_cast<size_t>(stage)];
+	}
+
+	// Records the hook time spent since the previous call. Called once per frame on the game thread.
+	auto RecordHookFrame() -> void;
+
+	auto IsEnabled() const -> bool { return enabled.load(std::memory_order_relaxed); }
+	auto SetEnabled(bool value) -> void { enabled.store(value, std::memory_order_relaxed); }
+	// Game thread only, calls being recorded meanwhile may be lost.
+	auto Reset() -> void;
+
+private:
+	std::array<LatencyHistogram, StageCount> histograms;
+	std::atomic<bool> enabled = true;
+	uint64_t lastHookSum = 0;
+};
+
+// Records the time until it is destroyed or Stop() is called, if timings are enabled.
+class PerfScope {
+public:
+	PerfScope(PerfStats& stats, PerfStage stage) : stats(stats), stage(stage), start(stats.IsEnabled() ? PerfClock::Now() : 0) {}
+	PerfScope(const PerfScope&) = delete;
+	PerfScope& operator=(const PerfScope&) = delete;
+
+	~PerfScope() {
+		this->Stop();
+	}
+
+	auto Stop() -> void {
+		if (start) {
+			stats.Record(stage, PerfClock::Now() - start);
+			start = 0;
+		}
+	}
+
+private:
+	PerfStats& stats;
+	PerfStage stage;
+	uint64_t start;
+};
+
+// Times consecutive stages, each one starting where the previous one ended, with one clock read per stage.
+// Does nothing if timings are disabled or the weight is 0.
+class PerfLap {
+public:
+	explicit PerfLap(PerfStats& stats, uint32_t weight = 1)
+		: stats(stats), weight(weight), start(weight && stats.IsEnabled() ? PerfClock::Now() : 0), last(start) {}
+
+	// Records the time since the previous lap.
+	auto Lap(PerfStage stage) -> void {
+		if (!start) return;
+
+		const auto now = PerfClock::Now();
+		stats.Record(stage, now - last, weight);
+		last = now;
+	}
+
+	// Records the time from the start until the last lap.
+	auto Total(PerfStage stage) -> void {
+		if (start) stats.Record(stage, last - start, weight);
+	}
+
+private:
+	PerfStats& stats;
+	uint32_t weight;
+	uint64_t start;
+	uint64_t last;
+};
@@ -0,0 +1,613 @@
+#include "PinCapture.h"
+#include "MemoryUsage.h"
+#include "Properties.h"
+#include "PropertyDecoders.h"
+#include "SlabArena.h"
+#include <algorithm>
+#include <atomic>
+#include <format>
+#include <iterator>
+
+class ZObjectRefAccessible : public ZObjectRef {
+public:
+	void* GetData() const { return this->m_pData; }
+};
+
+// Writes into `out` without replacing its buffer so history slots keep their capacity.
+static auto PayloadToString(STypeID* type, void* data, std::string& out) {
+	auto typeInfo = type ? type->typeInfo() : nullptr;
+
+	out.clear();
+
+	if (typeInfo) {
+		// Payloads too large for the capture record are only shown by type.
+		if (!data) {
+			std::format_to(std::back_inserter(out), "<{}>", typeInfo->m_pTypeName);
+			return;
+		}
+
+		const auto decoder = PropertyDecoders::Resolve(type);
+		const auto prop = decoder.decode(type, data);
+		PropertyInfo::FormatBuffer s_Buffer;
+		const auto s_Text = prop.Format(s_Buffer);
+
+		if (decoder.supported)
+			std::format_to(std::back_inserter(out), "{}  ({})", s_Text, typeInfo->m_pTypeName);
+		else
+			out.append(s_Text);
+	}
+}
+
+PinCapture::~PinCapture() {
+	// Release any payloads still sitting in the ring.
+	captureRing.Drain([](PinCaptureRecord& record) {
+		if (record.hasData)
+			record.dataType->typeInfo()->m_pTypeFunctions->destruct(record.data);
+	});
+}
+
+auto PinCapture::OnPinOutput(ZEntityRef entity, uint32 pinId, const ZObjectRef& data) -> bool {
+	if (std::this_thread::get_id() != gameThread.load(std::memory_order_relaxed)) {
+		offThreadCalls.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+
+	static uint32 s_SampleCounter = 0;
+
+	PerfLap s_Lap(perf, ++s_SampleCounter % PerfStats::HookSampleInterval == 0 ? PerfStats::HookSampleInterval : 0);
+	std::chrono::steady_clock::time_point s_Now;
+
+	if (!this->Accept(entity, pinId, data, s_Now)) {
+		s_Lap.Lap(PerfStage::HookFilters);
+		s_Lap.Total(PerfStage::Hook);
+		return false;
+	}
+
+	s_Lap.Lap(PerfStage::HookFilters);
+
+	// Only record the raw event here, decoding happens in Update.
+	const auto s_Pushed = captureRing.TryPush([&](PinCaptureRecord& record) {
+		const auto s_DataType = data.GetTypeID();
+		const auto s_TypeInfo = s_DataType ? s_DataType->typeInfo() : nullptr;
+		const auto s_Data = reinterpret_cast<const ZObjectRefAccessible&>(data).GetData();
+
+		record.entity = entity;
+		record.entityType = entity->GetType();
+		record.entityId = record.entityType ? record.entityType->m_nEntityId : 0;
+		record.dataType = s_DataType;
+		record.timestamp = s_Now;
+		record.pinId = pinId;
+		record.hasData = s_TypeInfo && s_Data
+			&& s_TypeInfo->m_nTypeSize <= sizeof(record.data)
+			&& s_TypeInfo->m_nTypeAlignment <= PinCaptureRecord::InlineDataAlignment;
+
+		if (record.hasData)
+			s_TypeInfo->m_pTypeFunctions->copyConstruct(record.data, s_Data);
+	});
+
+	s_Lap.Lap(PerfStage::HookEnqueue);
+	s_Lap.Total(PerfStage::Hook);
+	return s_Pushed;
+}
+
+auto PinCapture::Accept(ZEntityRef entity, uint32 pinId, const ZObjectRef& data, std::chrono::steady_clock::time_point& now) -> bool {
+	// Rejection checks go from cheapest to most expensive and none of them format anything.
+	if (pinBlacklist.Contains(pinId) || !entity)
+		return false;
+
+	const auto s_EntityType = entity->GetType();
+	const auto s_InterfaceType = GetEntityInterfaceType(s_EntityType);
+
+	if (!pinCallEntityIDBlacklist.Empty() || !pinCallEntityTypeBlacklist.Empty()) {
+		if (s_EntityType && pinCallEntityIDBlacklist.Contains({ pinId, s_EntityType->m_nEntityId }))
+			return false;
+		if (pinCallEntityTypeBlacklist.Contains({ pinId, s_InterfaceType }))
+			return false;
+	}
+
+	// Types that haven't been seen since the filter changed are let through and checked when decoded.
+	if (!entityTypeFilter.MatchesAll()) {
+		const auto s_TypeMatches = entityTypeFilterResults.Find(s_InterfaceType);
+		if (s_TypeMatches && !*s_TypeMatches)
+			return false;
+	}
+
+	// The trigger only looks at names and properties for calls that got this far.
+	if (trigger) {
+		if (!trigger->Evaluate(triggerCache, pinId, entity, s_InterfaceType, data.GetTypeID(), reinterpret_cast<const ZObjectRefAccessible&>(data).GetData()))
+			return false;
+	}
+
+	now = std::chrono::steady_clock::now();
+
+	// Counted before rate limiting so pins flooding the event system stand out even while they're being limited.
+	if (callEventCount < CallEventCapacity)
+		callEvents[callEventCount++] = { pinId, s_InterfaceType, s_EntityType ? s_EntityType->m_nEntityId : 0, now };
+	else
+		missedCallEvents.fetch_add(1, std::memory_order_relaxed);
+
+	return !enableRateLimit || rateLimiter.Allow(pinId, s_InterfaceType, now);
+}
+
+auto PinCapture::Update(ZScene* scene) -> void {
+	gameThread.store(std::this_thread::get_id(), std::memory_order_relaxed);
+	++frameIndex;
+
+	const auto s_SceneChanged = scene != currentScene;
+
+	if (s_SceneChanged) {
+		this->OnSceneChanged();
+		currentScene = scene;
+	}
+
+	PerfLap s_Lap(perf);
+
+	this->FoldCallEvents();
+
+	captureRing.Drain([this, s_SceneChanged](PinCaptureRecord& record) {
+		// Records captured before a scene change may refer to entities that no longer exist.
+		if (!s_SceneChanged && currentScene)
+			this->ProcessCapture(record);
+
+		if (record.hasData)
+			record.dataType->typeInfo()->m_pTypeFunctions->destruct(record.data);
+	});
+
+	s_Lap.Lap(PerfStage::FrameDrain);
+
+	const auto s_Now = std::chrono::steady_clock::now();
+
+	if (s_Now - lastRatePruneTime >= std::chrono::seconds(3)) {
+		rateLimiter.Prune(s_Now);
+		this->PruneCallStats(s_Now);
+		lastRatePruneTime = s_Now;
+		s_Lap.Lap(PerfStage::FrameRatePrune);
+	}
+}
+
+auto PinCapture::OnSceneChanged() -> void {
+	// The caches are keyed by pointers into the scene's entities, so they can't outlive it.
+	layoutCache.Clear();
+	treeCache.Clear();
+	propertyHistory.Clear();
+	propertyHistoryCount.store(0, std::memory_order_relaxed);
+	propertyHistoryBytes.store(propertyHistory.MemoryUsage(), std::memory_order_relaxed);
+	triggerCache.Clear();
+}
+
+auto PinCapture::FoldCallEvents() -> void {
+	if (callEventCount == 0) return;
+
+	for (size_t i = 0; i < callEventCount; ++i) {
+		const auto& event = callEvents[i];
+
+		// The pin may have been blacklisted since.
+		if (pinBlacklist.Contains(event.pinId)) continue;
+
+		pinStats[event.pinId].Record(event.entityType, event.timestamp);
+
+		if (auto [counter, inserted] = hotPins.Add({ event.pinId, event.entityId }); inserted)
+			counter->value.entityType = event.entityType;
+	}
+
+	callEventCount = 0;
+	++callStatsVersion;
+}
+
+auto PinCapture::PruneCallStats(std::chrono::steady_clock::time_point now) -> void {
+	size_t bytes = CallEventCapacity * sizeof(PinCallEvent) + pinStats.MemoryUsage() + hotPins.MemoryUsage();
+
+	pinStats.ForEach([&](uint32, PinCallStats& stats) {
+		for (size_t i = stats.types.size(); i-- > 0;) {
+			if (now - stats.byType[i].lastSeen >= std::chrono::minutes(1)) {
+				stats.types.erase(stats.types.begin() + i);
+				stats.byType.erase(stats.byType.begin() + i);
+			}
+		}
+
+		bytes += HeapBytes(stats.types) + HeapBytes(stats.byType);
+	});
+
+	callStatsBytes.store(bytes, std::memory_order_relaxed);
+}
+
+auto PinCapture::ProcessCapture(PinCaptureRecord& record) -> void {
+	const auto pinId = record.pinId;
+	const auto entity = record.entity;
+
+	PerfLap s_Lap(perf);
+
+	// This can't tell whether the entity was freed, as reading its type is already a read of its memory. It
+	// catches an entity whose type was swapped or whose address was reused by another entity since the signal.
+	auto s_EntityType = entity->GetType();
+
+	if (s_EntityType != record.entityType || (s_EntityType && s_EntityType->m_nEntityId != record.entityId)) {
+		staleCalls.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	auto s_EntityTree = treeCache.Get(entity);
+	const auto s_EntityId = s_EntityTree->entityId;
+	const auto s_EntityTypeName = s_EntityTree->name;
+
+	if (!entityTypeFilter.MatchesAll()) {
+		const auto s_TypeMatches = entityTypeFilter.Matches(s_EntityTypeName);
+		entityTypeFilterResults.Insert(s_EntityTree->typeId, s_TypeMatches);
+		if (!s_TypeMatches) return;
+	}
+
+	const auto s_EntityName = host.GetEntityName(entity);
+	s_Lap.Lap(PerfStage::DecodeEntity);
+
+	auto pin = pinData.Find(pinId);
+
+	if (pin) {
+		++pin->timesCalled;
+		pinData.Touch(pinId);
+	}
+	else {
+		auto name = host.GetPinName(pinId);
+		if (!nameFilter.Matches(name)) return;
+
+		// At the limit the least recently fired pin makes way, and its node and history slots are reused.
+		if (pinData.Size() >= pinLimit && !pinData.Empty()) {
+			historyBytes -= PinBytes(*pinData.Back());
+			pin = &pinData.RecycleBack(pinId);
+
+			for (auto& call : pin->calls)
+				call.reset();
+
+			pin->calls.Clear();
+			pin->timesCalled = 1;
+			pin->callBytes = 0;
+			historyBytes += PinBytes(*pin);
+		}
+		else
+			pin = &pinData.EmplaceFront(pinId);
+
+		pin->id = pinId;
+		pin->name = name;
+		pin->calls.SetCapacity(historyLimit);
+
+		while (pinData.Size() > pinLimit)
+			this->EvictLeastRecentPin();
+	}
+
+	// Fill the history slot in place so its storage is reused once the history is full, unless a
+	// published snapshot still refers to the call in it.
+	pin->view.reset();
+	++pinDataVersion;
+
+	const auto s_PinBytes = PinBytes(*pin);
+	const auto s_HistoryFull = pin->calls.Size() == pin->calls.Capacity();
+
+	auto& slot = pin->calls.PushFront();
+
+	// A full history hands back its oldest call, which is being replaced.
+	if (s_HistoryFull && slot)
+		pin->callBytes -= slot->retainedBytes;
+
+	if (slot && slot.use_count() == 1)
+		std::atomic_thread_fence(std::memory_order_acquire);
+	else
+		slot = std::allocate_shared<PinCallData>(SlabAllocator<PinCallData>());
+
+	auto& callData = *slot;
+	callData.entityId = s_EntityId;
+	callData.entityName = s_EntityName;
+	callData.entityType = s_EntityTypeName;
+	callData.entityTree = std::move(s_EntityTree);
+	s_Lap.Lap(PerfStage::DecodeStorage);
+
+	PayloadToString(record.dataType, record.GetData(), callData.data);
+	s_Lap.Lap(PerfStage::DecodePayload);
+
+	// Only the raw values are copied here, they are decoded when the call is displayed. Most calls only
+	// store the values that changed since the entity's previous call.
+	if (auto s_Layout = layoutCache.Get(s_EntityType))
+		callData.props = PropertySnapshot::Capture(entity, std::move(s_Layout), &this->GetPropertyHistory(entity, s_EntityId));
+	else
+		callData.props.reset();
+
+	s_Lap.Lap(PerfStage::DecodeProperties);
+
+	callData.retainedBytes = CallBytes(callData);
+	pin->callBytes += callData.retainedBytes;
+	historyBytes = historyBytes - s_PinBytes + PinBytes(*pin);
+	this->EnforceMemoryBudget();
+
+	if (captureWriter.IsOpen()) {
+		CaptureFormat::Record s_Record{};
+		s_Record.timestamp = captureWriter.TimestampFor(record.timestamp);
+		s_Record.entityId = callData.entityId;
+		s_Record.frame = frameIndex;
+		s_Record.pinId = pinId;
+		s_Record.pinName = pin->name;
+		s_Record.entityType = callData.entityType;
+		s_Record.entityName = callData.entityName;
+		s_Record.dataType = record.dataType && record.dataType->typeInfo() ? Intern(record.dataType->typeInfo()->m_pTypeName) : 0;
+		captureWriter.Append(s_Record, callData.data);
+		s_Lap.Lap(PerfStage::DecodeRecord);
+	}
+}
+
+auto PinCapture::GetPropertyHistory(ZEntityRef entity, uint64 entityId) -> PropertyHistory& {
+	// Rather than tracking which entity was captured least recently, which costs a few cache misses on every
+	// call, all histories are dropped once there are too many. Each entity then starts over with a keyframe.
+	if (propertyHistory.Size() >= PropertyHistoryLimit)
+		propertyHistory.Clear();
+
+	auto [history, inserted] = propertyHistory.TryEmplace(entity.m_pEntity);
+
+	if (inserted) {
+		propertyHistoryCount.store(propertyHistory.Size(), std::memory_order_relaxed);
+		propertyHistoryBytes.store(propertyHistory.MemoryUsage(), std::memory_order_relaxed);
+	}
+
+	// Another entity may have been created at the address of one that was destroyed.
+	if (history->entityId != entityId) {
+		history->last.reset();
+		history->entityId = entityId;
+	}
+
+	return *history;
+}
+
+auto PinCapture::CallBytes(const PinCallData& call) -> size_t {
+	// Keyframes are shared with the deltas based on them and counted on their own.
+	const auto s_PropsBytes = call.props && !call.props->IsKeyframe() ? call.props->MemoryUsage() : 0;
+	return SlabSharedBytes<PinCallData> + HeapBytes(call.data) + s_PropsBytes;
+}
+
+auto PinCapture::PinBytes(const PinData& pin) -> size_t {
+	return pin.calls.MemoryUsage() + pin.callBytes;
+}
+
+auto PinCapture::EvictLeastRecentPin() -> void {
+	if (auto pin = pinData.Back()) {
+		historyBytes -= PinBytes(*pin);
+		pinData.PopBack();
+	}
+}
+
+auto PinCapture::TrimCalls(PinData& pin, size_t keep) -> void {
+	const auto s_PinBytes = PinBytes(pin);
+
+	while (pin.calls.Size() > keep) {
+		// Release the call now rather than leaving it in the unused slot until it is reused.
+		auto& call = pin.calls.Back();
+		pin.callBytes -= call->retainedBytes;
+		call.reset();
+		pin.calls.PopBack();
+	}
+
+	pin.view.reset();
+	historyBytes = historyBytes - s_PinBytes + PinBytes(pin);
+}
+
+auto PinCapture::UnattributedBytes() const -> size_t {
+	return treeCache.MemoryUsage() + propertyHistoryBytes.load(std::memory_order_relaxed)
+		+ PropertySnapshot::KeyframeBytes() + PropertySnapshot::MaterializedBytes();
+}
+
+auto PinCapture::EnforceMemoryBudget() -> void {
+	// Evicting calls may release keyframes and decoded properties, unless a published snapshot still holds
+	// them, so those are checked again after every eviction.
+	const auto s_OverBudget = [this] {
+		return historyBytes + pinData.MemoryUsage() + this->UnattributedBytes() > memoryBudget;
+	};
+
+	// Every pin keeps at least its newest call, the most recently fired pin is never evicted.
+	while (s_OverBudget() && pinData.Size() > 1) {
+		this->EvictLeastRecentPin();
+		evictedPins.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	if (s_OverBudget() && !pinData.Empty()) {
+		auto& pin = *pinData.begin();
+
+		while (pin.calls.Size() > 1 && s_OverBudget()) {
+			this->TrimCalls(pin, pin.calls.Size() - 1);
+			evictedCalls.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	this->UpdateMemoryStats();
+}
+
+auto PinCapture::UpdateMemoryStats() -> void {
+	const auto s_PinsBytes = historyBytes + pinData.MemoryUsage();
+	pinsBytes.store(s_PinsBytes, std::memory_order_relaxed);
+	retainedBytes.store(s_PinsBytes + this->UnattributedBytes(), std::memory_order_relaxed);
+}
+
+auto PinCapture::PublishSnapshot() -> void {
+	const auto s_InspectedPin = inspectedPin.load(std::memory_order_relaxed);
+
+	if (pinDataVersion == publishedVersion && callStatsVersion == publishedCallStatsVersion && s_InspectedPin == publishedInspectedPin)
+		return;
+
+	auto snapshot = std::make_shared<PinSnapshot>();
+	snapshot->pins.reserve(pinData.Size());
+	snapshot->stats.reserve(pinData.Size());
+	snapshot->time = std::chrono::steady_clock::now();
+	size_t bytes = sizeof(PinSnapshot) + SharedControlBlockBytes + HeapBytes(snapshot->pins);
+
+	for (auto& data : pinData) {
+		if (!nameFilter.Matches(data.name)) continue;
+
+		// Pins that haven't changed since the last snapshot share their previous view.
+		if (!data.view) {
+			auto view = std::make_shared<PinView>();
+			view->id = data.id;
+			view->timesCalled = data.timesCalled;
+			view->name = data.name;
+			view->calls.assign(data.calls.begin(), data.calls.end());
+			data.view = std::move(view);
+		}
+
+		snapshot->pins.push_back(data.view);
+		bytes += sizeof(PinView) + SharedControlBlockBytes + HeapBytes(data.view->calls);
+
+		const auto s_Stats = pinStats.Find(data.id);
+		snapshot->stats.push_back(s_Stats ? s_Stats->total : CallStats{});
+	}
+
+	// Type names are resolved here rather than in the hook, which doesn't touch strings.
+	if (const auto s_Stats = pinStats.Find(s_InspectedPin)) {
+		snapshot->typeStatsPin = s_InspectedPin;
+
+		for (size_t i = 0; i < s_Stats->types.size(); ++i) {
+			const auto s_Type = s_Stats->types[i];
+			snapshot->typeStats.push_back({ s_Type ? Intern(s_Type->typeInfo()->m_pTypeName) : Intern("???"), s_Stats->byType[i] });
+		}
+	}
+
+	hotPins.ForEachValue([this](const std::pair<uint32, uint64>& key, HotPinInfo& info) {
+		if (!info.pinName) {
+			info.pinName = host.GetPinName(key.first);
+			info.entityTypeName = info.entityType ? Intern(info.entityType->typeInfo()->m_pTypeName) : Intern("???");
+		}
+	});
+
+	// Blacklisted pins can't fire any more, but their counters stay until other pairs take them over.
+	const auto s_HotPins = hotPins.Top(HotPinsShown, [this](const auto& counter) {
+		return !pinBlacklist.Contains(counter.key.first);
+	});
+	snapshot->hotPins.reserve(s_HotPins.size());
+	snapshot->hotPinsTotal = hotPins.Total();
+	snapshot->hotPinsMaxError = hotPins.MaxError();
+
+	for (auto& counter : s_HotPins)
+		snapshot->hotPins.push_back({ counter.key.first, counter.key.second, counter.value.pinName, counter.value.entityTypeName, counter.count, counter.error });
+
+	bytes += HeapBytes(snapshot->stats) + HeapBytes(snapshot->typeStats) + HeapBytes(snapshot->hotPins);
+	publishedVersion = pinDataVersion;
+	publishedCallStatsVersion = callStatsVersion;
+	publishedInspectedPin = s_InspectedPin;
+	snapshotBytes.store(bytes, std::memory_order_relaxed);
+
+	std::shared_ptr<const PinSnapshot> previous = std::move(snapshot);
+	{
+		auto lock = std::scoped_lock(snapshotLock);
+		displaySnapshot.swap(previous);
+	}
+}
+
+auto PinCapture::GetSnapshot() -> std::shared_ptr<const PinSnapshot> {
+	auto lock = std::scoped_lock(snapshotLock);
+	return displaySnapshot;
+}
+
+auto PinCapture::BlacklistPin(uint32 pinId) -> void {
+	pinBlacklist.Insert(pinId);
+	pinStats.Erase(pinId);
+	// Republishes the hot pins without the pin's pairs, even when the pin itself was no longer captured.
+	++callStatsVersion;
+
+	if (auto pin = pinData.Find(pinId)) {
+		historyBytes -= PinBytes(*pin);
+		pinData.Erase(pinId);
+		this->UpdateMemoryStats();
+		++pinDataVersion;
+	}
+
+	this->PublishSnapshot();
+}
+
+auto PinCapture::BlacklistEntity(uint32 pinId, uint64 entityId) -> void {
+	pinCallEntityIDBlacklist.Insert({ pinId, entityId });
+}
+
+auto PinCapture::BlacklistEntityType(uint32 pinId, STypeID* entityType) -> void {
+	pinCallEntityTypeBlacklist.Insert({ pinId, entityType });
+}
+
+auto PinCapture::ClearBlacklists() -> void {
+	pinBlacklist.Clear();
+	pinCallEntityIDBlacklist.Clear();
+	pinCallEntityTypeBlacklist.Clear();
+}
+
+auto PinCapture::ClearPins() -> void {
+	pinData.Clear();
+	historyBytes = 0;
+	callEventCount = 0;
+	pinStats.Clear();
+	hotPins.Clear();
+	this->UpdateMemoryStats();
+	++pinDataVersion;
+}
+
+auto PinCapture::SetHistoryLimit(size_t limit) -> void {
+	if (limit == historyLimit) return;
+
+	historyLimit = limit;
+
+	for (auto& pin : pinData) {
+		this->TrimCalls(pin, historyLimit);
+
+		const auto s_PinBytes = PinBytes(pin);
+		pin.calls.SetCapacity(historyLimit);
+		historyBytes = historyBytes - s_PinBytes + PinBytes(pin);
+	}
+
+	this->UpdateMemoryStats();
+	++pinDataVersion;
+}
+
+auto PinCapture::SetPinLimit(size_t limit) -> void {
+	if (limit == pinLimit) return;
+
+	pinLimit = limit;
+
+	while (pinData.Size() > pinLimit)
+		this->EvictLeastRecentPin();
+
+	this->UpdateMemoryStats();
+	++pinDataVersion;
+}
+
+auto PinCapture::SetMemoryBudget(size_t bytes) -> void {
+	if (bytes == memoryBudget) return;
+
+	memoryBudget = bytes;
+	this->EnforceMemoryBudget();
+	++pinDataVersion;
+}
+
+auto PinCapture::SetRateLimit(bool enabled, float perSecond, uint32 sampleOneIn) -> void {
+	enableRateLimit = enabled;
+	rateLimiter.Configure(perSecond, 3.f, sampleOneIn);
+}
+
+auto PinCapture::SetFilters(std::string_view name, std::string_view entityType) -> bool {
+	if (nameFilter.SetQuery(name))
+		++pinDataVersion;
+	if (entityTypeFilter.SetQuery(entityType))
+		entityTypeFilterResults.Clear();
+
+	return nameFilter.IsValid() && entityTypeFilter.IsValid();
+}
+
+auto PinCapture::SetTrigger(std::string_view text) -> bool {
+	if (text != triggerText) {
+		triggerText = text;
+
+		trigger = std::make_unique<const Trigger>(text, [this](std::string_view name) { return host.GetPinId(name); });
+		triggerError = trigger->GetError();
+
+		if (trigger->MatchesAll())
+			trigger.reset();
+	}
+
+	return triggerError.empty();
+}
+
+auto PinCapture::StartRecording(const std::filesystem::path& path) -> bool {
+	return captureWriter.Open(path);
+}
+
+auto PinCapture::StopRecording() -> void {
+	captureWriter.Close();
+}
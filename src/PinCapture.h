@@ -0,0 +1,343 @@
+#pragma once
+#include "CallStats.h"
+#include "CaptureRing.h"
+#include "CaptureWriter.h"
+#include "EntityLayoutCache.h"
+#include "EntityTreeCache.h"
+#include "Filter.h"
+#include "FlatHashMap.h"
+#include "HistoryRing.h"
+#include "PerfStats.h"
+#include "PropertySnapshot.h"
+#include "RateLimiter.h"
+#include "RecentMap.h"
+#include "SpaceSaving.h"
+#include "StringInterner.h"
+#include "Trigger.h"
+#include <Glacier/ZEntity.h>
+#include <Glacier/ZObject.h>
+#include <Glacier/ZScene.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+struct PinCallData {
+	uint64 entityId = 0;
+	Symbol entityName = 0;
+	Symbol entityType = 0;
+	std::shared_ptr<const EntityTreeNode> entityTree;
+	std::string data;
+	std::shared_ptr<PropertySnapshot> props;
+	// Bytes owned by this call, counted against the memory budget. Entity tree nodes are shared and counted by the tree cache.
+	size_t retainedBytes = 0;
+};
+
+// Immutable view of a pin handed to the UI. The calls are shared with the capture side, not copied.
+struct PinView {
+	uint32 id = -1;
+	uint64 timesCalled = 0;
+	Symbol name = 0;
+	std::vector<std::shared_ptr<const PinCallData>> calls;
+};
+
+// Call statistics of a pin, overall and for each entity type it has been called for.
+struct PinCallStats {
+	CallStats total;
+	// Most pins are only called for a handful of types, so they are searched linearly. The types are kept
+	// apart from their statistics to keep that search within a cache line or two.
+	std::vector<STypeID*> types;
+	std::vector<CallStats> byType;
+
+	auto Record(STypeID* entityType, std::chrono::steady_clock::time_point now) -> void {
+		total.Record(now);
+
+		const auto it = std::find(types.begin(), types.end(), entityType);
+
+		if (it != types.end()) {
+			byType[it - types.begin()].Record(now);
+			return;
+		}
+
+		types.push_back(entityType);
+		byType.emplace_back().Record(now);
+	}
+};
+
+// A call the hook let through to the call statistics, folded into them in Update.
+struct PinCallEvent {
+	uint32 pinId = 0;
+	STypeID* entityType = nullptr;
+	uint64 entityId = 0;
+	std::chrono::steady_clock::time_point timestamp;
+};
+
+struct EntityTypeCallStats {
+	Symbol entityType = 0;
+	CallStats stats;
+};
+
+// Approximate call count of one of the busiest (pin, entity) pairs. The true count is somewhere between
+// `count - error` and `count`.
+struct HotPin {
+	uint32 pinId = 0;
+	uint64 entityId = 0;
+	Symbol pinName = 0;
+	Symbol entityType = 0;
+	uint64 count = 0;
+	uint64 error = 0;
+};
+
+// Immutable set of pins as shown by the UI, most recently fired first.
+struct PinSnapshot {
+	std::vector<std::shared_ptr<const PinView>> pins;
+	// Statistics of each pin in `pins`, at the same index. Unlike the calls they include rate limited calls.
+	std::vector<CallStats> stats;
+	// Statistics of the inspected pin by entity type.
+	uint32 typeStatsPin = -1;
+	std::vector<EntityTypeCallStats> typeStats;
+	// Busiest (pin, entity) pairs, busiest first, out of `hotPinsTotal` calls. Pairs not listed were called at
+	// most `hotPinsMaxError` times.
+	std::vector<HotPin> hotPins;
+	uint64 hotPinsTotal = 0;
+	uint64 hotPinsMaxError = 0;
+	std::chrono::steady_clock::time_point time;
+};
+
+struct PinData {
+	uint32 id = -1;
+	uint64 timesCalled = 1;
+	Symbol name = 0;
+	// Calls are only modified in place while no published view still refers to them.
+	HistoryRing<std::shared_ptr<PinCallData>> calls;
+	// Sum of the retained bytes of the calls.
+	size_t callBytes = 0;
+	// Last published view of this pin, reset whenever the pin changes.
+	std::shared_ptr<const PinView> view;
+};
+
+// Captured pins keyed by pin ID, most recently fired first.
+using PinStore = RecentMap<uint32, PinData>;
+
+// Raw record of a single pin signal, captured in the hook and decoded later on the game thread. Only the pin,
+// payload and time are taken at signal time. The entity's name, ancestry and properties are read when the
+// record is decoded at the end of the frame, so they show the entity as it is then.
+struct PinCaptureRecord {
+	static constexpr size_t InlineDataSize = 64;
+	static constexpr size_t InlineDataAlignment = 16;
+
+	ZEntityRef entity;
+	// The entity's type and ID when it was signalled, compared against the entity's at decode time to drop
+	// calls whose entity was replaced by another at the same address. Decoding still reads the entity, so it
+	// relies on the game not freeing entities within the frame they signal in.
+	ZEntityType* entityType = nullptr;
+	uint64 entityId = 0;
+	STypeID* dataType = nullptr;
+	std::chrono::steady_clock::time_point timestamp;
+	uint32 pinId = 0;
+	bool hasData = false;
+	alignas(InlineDataAlignment) std::byte data[InlineDataSize];
+
+	auto GetData() -> void* {
+		return hasData ? static_cast<void*>(data) : nullptr;
+	}
+};
+
+using PinCaptureRing = CaptureRing<PinCaptureRecord, 4096>;
+
+// Game services the capture pipeline needs beyond what the entities and types themselves provide.
+class IPinCaptureHost {
+public:
+	virtual ~IPinCaptureHost() = default;
+
+	virtual auto GetPinName(uint32 pinId) -> Symbol = 0;
+	virtual auto GetEntityName(ZEntityRef entity) -> Symbol = 0;
+	// Pin ID for a pin name written in a trigger, if there is one.
+	virtual auto GetPinId(std::string_view name) -> std::optional<uint32> = 0;
+};
+
+// Everything between the pin hook and the UI: rejecting calls, queueing them, decoding them into per-pin
+// history and publishing snapshots of it. The hook and everything else run on the game thread, which is why
+// the blacklists, filter caches, rate limiter and trigger cache the hook reads need no locking. Only
+// GetSnapshot, SetInspectedPin and the stat getters may be used off the game thread.
+class PinCapture {
+public:
+	// Number of (pin, entity) pairs tracked by the hot pins sketch, and how many of them are published.
+	static constexpr size_t HotPinCapacity = 512;
+	static constexpr size_t HotPinsShown = 100;
+	// Calls the hook can count for the call statistics between two updates.
+	static constexpr size_t CallEventCapacity = 8192;
+	// Number of entities whose last property capture is kept to delta encode the next one against.
+	static constexpr size_t PropertyHistoryLimit = 4096;
+
+	explicit PinCapture(IPinCaptureHost& host) : host(host) {}
+	PinCapture(const PinCapture&) = delete;
+	PinCapture& operator=(const PinCapture&) = delete;
+	~PinCapture();
+
+	// Called from the hook, on the game thread. Calls from any other thread are rejected and counted, as the
+	// state the hook reads is only ever touched by the game thread. Returns false if the call was rejected or
+	// the ring was full.
+	auto OnPinOutput(ZEntityRef entity, uint32 pinId, const ZObjectRef& data) -> bool;
+
+	// Decodes queued calls. Calls queued before a scene change are discarded along with the caches.
+	auto Update(ZScene* scene) -> void;
+	// Publishes a new snapshot if anything changed since the last one.
+	auto PublishSnapshot() -> void;
+	auto GetSnapshot() -> std::shared_ptr<const PinSnapshot>;
+	// Selects the pin whose statistics by entity type are included in the snapshots.
+	auto SetInspectedPin(uint32 pinId) -> void { inspectedPin.store(pinId, std::memory_order_relaxed); }
+
+	auto BlacklistPin(uint32 pinId) -> void;
+	auto BlacklistEntity(uint32 pinId, uint64 entityId) -> void;
+	auto BlacklistEntityType(uint32 pinId, STypeID* entityType) -> void;
+	auto ClearBlacklists() -> void;
+	auto ClearPins() -> void;
+
+	auto SetHistoryLimit(size_t limit) -> void;
+	auto SetPinLimit(size_t limit) -> void;
+	// Least recently fired pins are evicted first, then the oldest calls of the remaining pin.
+	auto SetMemoryBudget(size_t bytes) -> void;
+	auto SetRateLimit(bool enabled, float perSecond, uint32 sampleOneIn) -> void;
+	// Returns false if either query is invalid, in which case that filter lets everything through.
+	auto SetFilters(std::string_view name, std::string_view entityType) -> bool;
+	// Compiles the trigger calls must satisfy to be captured. Returns false if it doesn't compile, in which case
+	// GetTriggerError says why and every call is let through.
+	auto SetTrigger(std::string_view text) -> bool;
+	auto GetTriggerError() const -> std::string_view { return triggerError; }
+
+	auto StartRecording(const std::filesystem::path& path) -> bool;
+	auto StopRecording() -> void;
+
+	auto GetCaptureRing() const -> const PinCaptureRing& { return captureRing; }
+	auto GetCaptureWriter() const -> const CaptureWriter& { return captureWriter; }
+	auto GetRateLimiter() const -> const RateLimiter& { return rateLimiter; }
+	auto GetTreeCache() const -> const EntityTreeCache& { return treeCache; }
+	// Bytes held by the call statistics and the hot pins sketch, which are kept outside of the memory budget.
+	auto CallStatsBytes() const -> size_t { return callStatsBytes.load(std::memory_order_relaxed); }
+	// Calls left out of the call statistics because more than CallEventCapacity arrived between two updates.
+	auto MissedCallEvents() const -> uint64 { return missedCallEvents.load(std::memory_order_relaxed); }
+	// Hook calls rejected because they didn't come from the game thread.
+	auto OffThreadCalls() const -> uint64 { return offThreadCalls.load(std::memory_order_relaxed); }
+	auto GetMemoryBudget() const -> size_t { return memoryBudget; }
+	// Bytes the memory budget applies to: the captured pins and their calls, the property keyframes and
+	// histories, the properties decoded for display and the entity tree cache.
+	auto RetainedBytes() const -> size_t { return retainedBytes.load(std::memory_order_relaxed); }
+	// The part of RetainedBytes() held by the captured pins and their calls.
+	auto PinsBytes() const -> size_t { return pinsBytes.load(std::memory_order_relaxed); }
+	// Bytes held by the latest published snapshot on top of the calls it shares.
+	auto SnapshotBytes() const -> size_t { return snapshotBytes.load(std::memory_order_relaxed); }
+	auto EvictedPins() const -> uint64 { return evictedPins.load(std::memory_order_relaxed); }
+	auto EvictedCalls() const -> uint64 { return evictedCalls.load(std::memory_order_relaxed); }
+	// Queued calls dropped because their entity no longer had the type and ID it was signalled with.
+	auto StaleCalls() const -> uint64 { return staleCalls.load(std::memory_order_relaxed); }
+	auto PropertyHistoryCount() const -> size_t { return propertyHistoryCount.load(std::memory_order_relaxed); }
+	// Bytes of the property history map. The captures it refers to are held and counted by the calls.
+	auto PropertyHistoryBytes() const -> size_t { return propertyHistoryBytes.load(std::memory_order_relaxed); }
+	auto GetPerfStats() -> PerfStats& { return perf; }
+	auto GetPerfStats() const -> const PerfStats& { return perf; }
+
+private:
+	// The hook's rejection checks. Sets `now` once it is needed for rate limiting.
+	auto Accept(ZEntityRef entity, uint32 pinId, const ZObjectRef& data, std::chrono::steady_clock::time_point& now) -> bool;
+	auto OnSceneChanged() -> void;
+	// Adds the calls the hook recorded since the last update to the call statistics.
+	auto FoldCallEvents() -> void;
+	// Drops statistics of entity types a pin hasn't been called for in a while.
+	auto PruneCallStats(std::chrono::steady_clock::time_point now) -> void;
+	auto ProcessCapture(PinCaptureRecord& record) -> void;
+	auto GetPropertyHistory(ZEntityRef entity, uint64 entityId) -> PropertyHistory&;
+
+	static auto CallBytes(const PinCallData& call) -> size_t;
+	static auto PinBytes(const PinData& pin) -> size_t;
+	auto EvictLeastRecentPin() -> void;
+	// Drops the oldest calls of a pin until it has at most `keep` left.
+	auto TrimCalls(PinData& pin, size_t keep) -> void;
+	// Retained bytes that evicting a pin doesn't release right away, as they are shared between calls or only
+	// freed once the calls they belong to are no longer displayed.
+	auto UnattributedBytes() const -> size_t;
+	auto EnforceMemoryBudget() -> void;
+	auto UpdateMemoryStats() -> void;
+
+	IPinCaptureHost& host;
+	// Thread Update runs on, taken to be the one constructing the capture until the first update.
+	std::atomic<std::thread::id> gameThread = std::this_thread::get_id();
+	std::atomic<uint64> offThreadCalls = 0;
+	PerfStats perf;
+	PinCaptureRing captureRing;
+	CaptureWriter captureWriter;
+	EntityLayoutCache layoutCache;
+	EntityTreeCache treeCache;
+	// Keyed by entity pointer like the tree cache.
+	FlatHashMap<ZEntityType**, PropertyHistory> propertyHistory;
+	std::atomic<size_t> propertyHistoryCount = 0;
+	std::atomic<size_t> propertyHistoryBytes = 0;
+	ZScene* currentScene = nullptr;
+	uint32 frameIndex = 0;
+
+	// Checked in the hook, so keyed by raw IDs rather than anything that needs formatting.
+	FlatHashSet<uint32> pinBlacklist;
+	FlatHashSet<std::pair<uint32, uint64>> pinCallEntityIDBlacklist;
+	FlatHashSet<std::pair<uint32, STypeID*>> pinCallEntityTypeBlacklist;
+	// Keyed by (pin, entity interface type), checked in the hook and pruned in Update.
+	RateLimiter rateLimiter;
+	std::chrono::steady_clock::time_point lastRatePruneTime;
+	bool enableRateLimit = true;
+
+	// The hook only appends to this fixed array, so it never allocates, and the statistics below are updated
+	// from it in Update.
+	std::unique_ptr<PinCallEvent[]> callEvents = std::make_unique<PinCallEvent[]>(CallEventCapacity);
+	size_t callEventCount = 0;
+	std::atomic<uint64> missedCallEvents = 0;
+	FlatHashMap<uint32, PinCallStats> pinStats;
+	// Names are resolved when publishing, the hook only fills in the entity type.
+	struct HotPinInfo {
+		STypeID* entityType = nullptr;
+		Symbol pinName = 0;
+		Symbol entityTypeName = 0;
+	};
+	SpaceSaving<std::pair<uint32, uint64>, HotPinInfo> hotPins{ HotPinCapacity };
+	uint64 callStatsVersion = 0;
+	uint64 publishedCallStatsVersion = 0;
+	std::atomic<uint32> inspectedPin = -1;
+	uint32 publishedInspectedPin = -1;
+	std::atomic<size_t> callStatsBytes = 0;
+
+	SymbolFilter nameFilter;
+	SymbolFilter entityTypeFilter;
+	// Entity type filter results by type, so the hook can reject calls without resolving any names.
+	FlatHashMap<STypeID*, bool> entityTypeFilterResults;
+	// Checked in the hook after the blacklists and the entity type filter, before the call is counted. Null
+	// when every call is let through.
+	std::unique_ptr<const Trigger> trigger;
+	// Emptied when the scene changes, as the property tables it refers to belong to the scene.
+	Trigger::Cache triggerCache;
+	std::string triggerText;
+	std::string triggerError;
+
+	PinStore pinData;
+	size_t historyLimit = 10;
+	size_t pinLimit = 200;
+	size_t memoryBudget = 64 * 1024 * 1024;
+	// Sum of PinBytes() over all pins, the pin store's own nodes are added on top in UpdateMemoryStats.
+	size_t historyBytes = 0;
+	std::atomic<size_t> pinsBytes = 0;
+	std::atomic<size_t> retainedBytes = 0;
+	std::atomic<size_t> snapshotBytes = 0;
+	std::atomic<uint64> evictedPins = 0;
+	std::atomic<uint64> evictedCalls = 0;
+	std::atomic<uint64> staleCalls = 0;
+	uint64 pinDataVersion = 0;
+	uint64 publishedVersion = 0;
+
+	// The UI only ever copies this pointer, snapshotLock guards nothing else.
+	std::shared_ptr<const PinSnapshot> displaySnapshot;
+	std::mutex snapshotLock;
+};
@@ -1,5 +1,8 @@
 #include "PinCushion.h"
+#include "CallJson.h"
+#include "SlabArena.h"
 #include "Properties.h"
+#include "StaticPinSet.h"
 #include <Logging.h>
 #include <IconsMaterialDesign.h>
 #include <ResourceLib_HM3.h>
@@ -13,14 +16,13 @@
 #include <algorithm>
 #include <chrono>
 #include <format>
-#include <set>
-#include <map>
+#include <span>
 #include <string>
 
 using namespace std::string_literals;
 using namespace std::string_view_literals;
 
-std::set<uint32> permaBlacklist = {
+static constexpr auto s_PermaBlacklist = StaticPinSet(std::to_array<uint32>({
 	uint32(ZHMPin::OnDeactivate),
 	uint32(ZHMPin::OnTerminate),
 	uint32(ZHMPin::OnRelease),
@@ -120,82 +122,7 @@ std::set<uint32> permaBlacklist = {
 	4060967557,
 	2488885864,
 	3492492454,
-};
-
-std::map<std::pair<ZHMPin, std::string>, uint32> pinCallFrequency;
-
-class ZObjectRefAccessible : public ZObjectRef {
-public:
-	void* GetData() const { return this->m_pData; }
-};
-
-static auto ZObjectRefToString(const ZObjectRef& obj, std::string& out) {
-	auto type = obj.GetTypeID();
-	auto typeInfo = type ? type->typeInfo() : nullptr;
-
-	if (typeInfo) {
-		const std::string s_TypeName = typeInfo->m_pTypeName;
-		
-		PropertyInfo prop;
-		bool unk = false;
-
-		if (s_TypeName == "ZString")
-			prop = Properties::StringProperty(type, obj.As<ZString>());
-		else if (s_TypeName == "bool")
-			prop = Properties::BoolProperty(type, obj.As<bool>());
-		else if (s_TypeName == "uint8")
-			prop = Properties::Uint8Property(type, obj.As<uint8>());
-		else if (s_TypeName == "int8")
-			prop = Properties::Int8Property(type, obj.As<int8>());
-		else if (s_TypeName == "uint16")
-			prop = Properties::Uint16Property(type, obj.As<uint16>());
-		else if (s_TypeName == "int16")
-			prop = Properties::Int16Property(type, obj.As<int16>());
-		else if (s_TypeName == "uint32")
-			prop = Properties::Uint32Property(type, obj.As<uint32>());
-		else if (s_TypeName == "int32")
-			prop = Properties::Int32Property(type, obj.As<int32>());
-		else if (s_TypeName == "uint64")
-			prop = Properties::Uint64Property(type, obj.As<uint64>());
-		else if (s_TypeName == "int64")
-			prop = Properties::Int64Property(type, obj.As<int64>());
-		else if (s_TypeName == "float32")
-			prop = Properties::Float32Property(type, obj.As<float32>());
-		else if (s_TypeName == "float64")
-			prop = Properties::Float64Property(type, obj.As<float64>());
-		else if (s_TypeName == "SVector2")
-			prop = Properties::SVector2Property(type, obj.As<SVector2>());
-		else if (s_TypeName == "SVector3")
-			prop = Properties::SVector3Property(type, obj.As<SVector3>());
-		else if (s_TypeName == "SVector4")
-			prop = Properties::SVector4Property(type, obj.As<SVector4>());
-		else if (s_TypeName == "SMatrix43")
-			prop = Properties::SMatrix43Property(type, obj.As<SMatrix43>());
-		else if (s_TypeName == "SColorRGB")
-			prop = Properties::SColorRGBProperty(type, obj.As<SColorRGB>());
-		else if (s_TypeName == "SColorRGBA")
-			prop = Properties::SColorRGBAProperty(type, obj.As<SColorRGBA>());
-		else if (type->typeInfo()->isEnum())
-			prop = Properties::EnumProperty(type, reinterpret_cast<const ZObjectRefAccessible&>(obj).GetData());
-		else if (type->typeInfo()->isResource())
-			prop = Properties::ResourceProperty(type, obj.As<ZResourcePtr>());
-		else if (s_TypeName == "ZRepositoryID")
-			prop = Properties::ZRepositoryIDProperty(type, obj.As<ZRepositoryID>());
-		else if (s_TypeName == "ZDynamicObject")
-			prop = Properties::ZDynamicObjectProperty(type, obj.As<ZDynamicObject>());
-		//else if (s_TypeName.starts_with("TEntityRef<"))
-		//	Properties::TEntityRefProperty(s_InputId, s_Entity, s_Property, s_Data);
-		else {
-			unk = true;
-			prop = Properties::UnsupportedProperty(type, nullptr);
-		}
-
-		out = unk ? prop.ToString() : std::format("{}  ({})", prop.ToString(), s_TypeName);
-		return;
-	}
-
-	out = "";
-}
+}));
 
 static void CopyToClipboard(const std::string& p_String) {
 	if (!OpenClipboard(nullptr))
@@ -227,80 +154,50 @@ static void CopyToClipboard(const std::string& p_String) {
 	CloseClipboard();
 }
 
-static auto getEntityLeafID(ZEntityRef entity) -> std::string {
-	auto type = entity->GetType();
-	if (!type) return "???";
-	return fmt::format("{:016x}", type->m_nEntityId);
-}
-
-static auto getEntityLeafName(ZEntityRef entity) -> std::string {
-	auto type = entity->GetType();
-	if (!type) return "???";
-	const auto& s_Interfaces = *type->m_pInterfaces;
-	return std::string(s_Interfaces[0].m_pTypeId->typeInfo()->m_pTypeName);
-
-}
-
-static auto getEntityTree(ZEntityRef entity, std::vector<NameIDPair>& tree) -> void {
-	if (!entity) return;
-	auto parent = entity.GetLogicalParent();
-	if (parent)
-		getEntityTree(parent, tree);
-	tree.push_back(NameIDPair{getEntityLeafID(entity), getEntityLeafName(entity)});
-}
-
-static auto getEntityTree(ZEntityRef entity) -> std::vector<NameIDPair> {
-	if (!entity) return {};
-	auto parent = entity.GetLogicalParent();
-	std::vector<NameIDPair> tree;
-	if (parent)
-		getEntityTree(parent, tree);
-	tree.push_back(NameIDPair{getEntityLeafID(entity), getEntityLeafName(entity)});
-	return tree;
-}
-
-static auto displayProperties(PinCallData& call) -> void {
+static auto displayProperties(std::vector<PropertyInfo>& props) -> void {
 	auto separate = false;
-	for (auto& prop : call.props) {
+	for (auto& prop : props) {
 		if (separate) ImGui::Separator();
 		else separate = true;
 		ImGui::PushFont(SDK()->GetImGuiBoldFont());
 
-		ImGui::TextUnformatted(prop.name.c_str());
+		// Values that changed since the entity's previous call stand out.
+		if (prop.changed) {
+			ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(1.0f, 0.8f, 0.3f, 1.0f));
+			ImGui::TextUnformatted(SymbolStr(prop.name));
+			ImGui::PopStyleColor();
+		}
+		else ImGui::TextUnformatted(SymbolStr(prop.name));
 
 		if (ImGui::IsItemHovered())
-			ImGui::SetTooltip("%s", prop.typeName.c_str());
+			ImGui::SetTooltip("%s", SymbolStr(prop.typeName));
 
 		ImGui::PopFont();
 		ImGui::SameLine();
 
 		ImGui::PushItemWidth(-1);
 
-		if (prop.rgb)
-			ImGui::ColorEdit3(prop.inputId.c_str(), &prop.rgb->r, ImGuiColorEditFlags_NoInputs);
-		else if (prop.rgba)
-			ImGui::ColorEdit4(prop.inputId.c_str(), &prop.rgba->r, ImGuiColorEditFlags_NoInputs);
-		else if (prop.enumValue) {
-			auto& enumVal = *prop.enumValue;
-			std::string s_CurrentValue;
-
-			for (auto& s_EnumValue : enumVal.type->m_entries) {
-				if (s_EnumValue.m_nValue != enumVal.value) continue;
-				s_CurrentValue = s_EnumValue.m_pName;
-			}
+		if (auto rgb = prop.Get<SColorRGB>())
+			ImGui::ColorEdit3(SymbolStr(prop.inputId), &rgb->r, ImGuiColorEditFlags_NoInputs);
+		else if (auto rgba = prop.Get<SColorRGBA>())
+			ImGui::ColorEdit4(SymbolStr(prop.inputId), &rgba->r, ImGuiColorEditFlags_NoInputs);
+		else if (auto enumVal = prop.Get<PropertyInfo_EnumValue>()) {
+			const auto s_CurrentValue = enumVal->Name();
 
-			if (ImGui::BeginCombo(prop.inputId.c_str(), s_CurrentValue.c_str())) {
-				for (auto& s_EnumValue : enumVal.type->m_entries)
-					ImGui::Selectable(s_EnumValue.m_pName, s_EnumValue.m_nValue == enumVal.value);
+			if (ImGui::BeginCombo(SymbolStr(prop.inputId), s_CurrentValue ? s_CurrentValue : "")) {
+				for (auto& s_EnumValue : enumVal->type->m_entries)
+					ImGui::Selectable(s_EnumValue.m_pName, s_EnumValue.m_nValue == enumVal->value);
 				ImGui::EndCombo();
 			}
 		}
 		else {
-			auto& str = prop.ToString();
+			// Formatted every frame, which for numbers is cheaper than keeping a string for every property.
+			PropertyInfo::FormatBuffer s_Buffer;
+			const auto str = prop.Format(s_Buffer);
 			if (str.empty())
-				ImGui::LabelText((prop.inputId + "t").c_str(), "%s", "<error>");
+				ImGui::LabelText((std::string(SymbolView(prop.inputId)) + "t").c_str(), "%s", "<error>");
 			else
-				ImGui::LabelText(prop.inputId.c_str(), "%s", str.c_str());
+				ImGui::LabelText(SymbolStr(prop.inputId), "%.*s", static_cast<int>(str.size()), str.data());
 		}
 	}
 }
@@ -338,288 +235,775 @@ void PinCushion::OnDrawMenu() {
 }
 
 void PinCushion::OnDrawUI(bool p_HasFocus) {
+	// Hands over what was clicked during the last draw, even if the window has been closed since.
+	this->SubmitRequest();
+
 	if (!m_ShowMessage)
 		return;
 	
+	PerfScope s_DrawScope(capture.GetPerfStats(), PerfStage::DrawUI);
+
 	ImGui::PushStyleVar(ImGuiStyleVar_WindowMinSize, { 650, 300 });
 
 	if (ImGui::Begin("PIN CUSHION", &m_ShowMessage)) {
-		static size_t selected = 0;
-		static std::string titleBuff;
-		auto lock = std::unique_lock(displayDataLock);
+		DrawState s_State;
 
-		ImGui::Checkbox("Rate Blocking", &this->enableRateBlock);
+		{
+			auto lock = std::shared_lock(displayDataLock);
+			s_State.frozenSnapshot = frozenSnapshot;
+			if (capture.GetCaptureWriter().IsOpen())
+				s_State.recordingPath = capture.GetCaptureWriter().GetPath().string();
+			s_State.memoryBudget = capture.GetMemoryBudget();
+		}
+
+		if (ImGui::BeginTabBar("Tabs")) {
+			if (ImGui::BeginTabItem("Pins")) {
+				this->DrawPinsTab(s_State);
+				ImGui::EndTabItem();
+			}
+			if (ImGui::BeginTabItem("Hot Pins")) {
+				this->DrawHotPinsTab(s_State);
+				ImGui::EndTabItem();
+			}
+			if (ImGui::BeginTabItem("Perf")) {
+				this->DrawPerfTab();
+				ImGui::EndTabItem();
+			}
+			ImGui::EndTabBar();
+		}
+	}
+	ImGui::End();
+	ImGui::PopStyleVar();
+}
+
+void PinCushion::SubmitRequest() {
+	if (!this->haveUpdateDataAction() || requestPending.load(std::memory_order_acquire))
+		return;
+
+	// Settings are clamped here so the UI shows the values that are actually applied.
+	uiRequest.rateLimit = std::max(uiRequest.rateLimit, 1);
+	uiRequest.sampleRate = std::max(uiRequest.sampleRate, 0);
+	uiRequest.historyLimit = std::clamp(uiRequest.historyLimit, 1, 1000);
+	uiRequest.pinLimit = std::clamp(uiRequest.pinLimit, 1, 100000);
+	uiRequest.memoryBudget = std::clamp(uiRequest.memoryBudget, 1, 64 * 1024);
+
+	auto lock = std::unique_lock(displayDataLock);
+	pendingRequest = uiRequest;
+	requestPending.store(true, std::memory_order_release);
+	uiRequest.action = UpdateDataAction::None;
+}
+
+void PinCushion::DrawPinsTab(const DrawState& state) {
+	static size_t selected = 0;
+	static std::string titleBuff;
+	static std::vector<const EntityTreeNode*> treePath;
+	static std::vector<std::pair<size_t, double>> pinOrder;
+
+	if (ImGui::Checkbox("Rate Blocking", &uiRequest.enableRateBlock) && !this->haveUpdateDataAction())
+		uiRequest.action = UpdateDataAction::RateLimit;
+	ImGui::SameLine();
+	ImGui::SetNextItemWidth(120);
+	if (ImGui::InputInt("Rate Limit", &uiRequest.rateLimit, 1, 120) && !this->haveUpdateDataAction())
+		uiRequest.action = UpdateDataAction::RateLimit;
+	if (ImGui::BeginItemTooltip()) {
+		ImGui::TextUnformatted("The number of times per-second a pin may fire for each entity type before further calls are dropped. Bursts of up to 3 seconds worth of calls are let through.");
+		ImGui::EndTooltip();
+	}
+	ImGui::SameLine();
+	ImGui::SetNextItemWidth(120);
+	if (ImGui::InputInt("Sample 1 in", &uiRequest.sampleRate, 1, 10) && !this->haveUpdateDataAction())
+		uiRequest.action = UpdateDataAction::SampleRate;
+	if (ImGui::BeginItemTooltip()) {
+		ImGui::TextUnformatted("When above 0, one in this many calls over the rate limit is still kept instead of all of them being dropped.");
+		ImGui::EndTooltip();
+	}
+	ImGui::SameLine();
+	ImGui::SetNextItemWidth(120);
+	if (ImGui::InputInt("Pin Limit", &uiRequest.pinLimit, 100, 1000) && !this->haveUpdateDataAction())
+		uiRequest.action = UpdateDataAction::PinLimit;
+	if (ImGui::BeginItemTooltip()) {
+		ImGui::TextUnformatted("The maximum number of distinct pins to keep. The least recently fired pins are dropped first.");
+		ImGui::EndTooltip();
+	}
+	ImGui::SameLine();
+	ImGui::SetNextItemWidth(120);
+	if (ImGui::InputInt("History", &uiRequest.historyLimit, 1, 10) && !this->haveUpdateDataAction())
+		uiRequest.action = UpdateDataAction::HistoryLimit;
+	if (ImGui::BeginItemTooltip()) {
+		ImGui::TextUnformatted("The number of most recent calls kept for each pin.");
+		ImGui::EndTooltip();
+	}
+	ImGui::SameLine();
+	ImGui::SetNextItemWidth(120);
+	if (ImGui::InputInt("Memory (MiB)", &uiRequest.memoryBudget, 16, 256) && !this->haveUpdateDataAction())
+		uiRequest.action = UpdateDataAction::MemoryBudget;
+	if (ImGui::BeginItemTooltip()) {
+		ImGui::TextUnformatted("The most memory the captured pins and calls may use. When over budget the least recently fired pins are dropped first, then the oldest calls of the remaining pin.");
+		ImGui::EndTooltip();
+	}
+	ImGui::SameLine();
+	if (ImGui::Button("Reset Blacklist") && !this->haveUpdateDataAction())
+		uiRequest.action = UpdateDataAction::ClearBlacklist;
+
+	static const std::vector<std::shared_ptr<const PinView>> noPins;
+	const auto frozen = state.frozenSnapshot != nullptr;
+	const auto snapshot = frozen ? state.frozenSnapshot : capture.GetSnapshot();
+	auto& activeList = snapshot ? snapshot->pins : noPins;
+	// A frozen snapshot keeps showing the rates as they were when it was taken.
+	const auto s_StatsTime = frozen ? snapshot->time : std::chrono::steady_clock::now();
+
+	ImGui::SameLine();
+	if (ImGui::Button(frozen ? "Unfreeze" : "Freeze") && !this->haveUpdateDataAction())
+		uiRequest.action = UpdateDataAction::ToggleFreeze;
+	ImGui::SameLine();
+	if (ImGui::Button("Clear") && !this->haveUpdateDataAction())
+		uiRequest.action = UpdateDataAction::Clear;
+	ImGui::SameLine();
+	auto& captureWriter = capture.GetCaptureWriter();
+	if (ImGui::Button(captureWriter.IsOpen() ? "Stop Recording" : "Record") && !this->haveUpdateDataAction())
+		uiRequest.action = UpdateDataAction::ToggleRecording;
+	if (ImGui::BeginItemTooltip()) {
+		ImGui::TextUnformatted("Appends every accepted pin call to a .pincap file in the game directory.");
+		ImGui::EndTooltip();
+	}
+	ImGui::SameLine();
+	if (ImGui::Button("Export JSON") && !this->haveUpdateDataAction())
+		uiRequest.action = UpdateDataAction::ExportJson;
+	if (ImGui::BeginItemTooltip()) {
+		ImGui::TextUnformatted("Writes the calls shown, or those of the frozen snapshot, to a .ndjson file in the game directory with one call per line.");
+		ImGui::EndTooltip();
+	}
+
+	if (captureWriter.IsOpen()) {
 		ImGui::SameLine();
-		ImGui::SetNextItemWidth(120);
-		if (ImGui::InputInt("Rate Limit", &uiRateLimit, 1, 120))
-			this->updateDataAction = UpdateDataAction::RateLimit;
+		if (captureWriter.Failed())
+			ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "Recording failed after %llu calls", captureWriter.RecordCount());
+		else
+			ImGui::Text("Recorded: %llu (%.1f MiB)", captureWriter.RecordCount(), captureWriter.BytesWritten() / (1024.0 * 1024.0));
 		if (ImGui::BeginItemTooltip()) {
-			ImGui::TextUnformatted("The number of times per-second a pin is allowed to be fired without being blocked. This is checked every 3 seconds, so one-off 'rapid-fire' pins may be spared if this number is not low.");
+			ImGui::Text("%s", state.recordingPath.c_str());
+			if (captureWriter.Failed())
+				ImGui::TextUnformatted("Writing to the file failed, possibly because the disk is full. Calls after that aren't recorded.");
+			if (captureWriter.DroppedCount() > 0)
+				ImGui::Text("%llu calls were dropped because the disk couldn't keep up.", captureWriter.DroppedCount());
 			ImGui::EndTooltip();
 		}
-		ImGui::SameLine();
-		if (ImGui::Button("Reset Blacklist") && !this->haveUpdateDataAction())
-			this->updateDataAction = UpdateDataAction::ClearBlacklist;
+	}
 
-		auto frozen = !frozenPinData.empty();
-		auto& activeList = frozen ? frozenPinData : displayPinData;
+	ImGui::SameLine();
+	auto& treeCache = capture.GetTreeCache();
+	const auto s_MiB = 1024.0 * 1024.0;
+	ImGui::TextDisabled("Memory: %.1f / %.0f MiB", capture.RetainedBytes() / s_MiB, state.memoryBudget / s_MiB);
+	if (ImGui::BeginItemTooltip()) {
+		ImGui::Text("Pins and calls: %.2f MiB", capture.PinsBytes() / s_MiB);
+		ImGui::Text("Property keyframes: %.2f MiB, shared by the captures that only store changes to them", PropertySnapshot::KeyframeBytes() / s_MiB);
+		ImGui::Text("Property history: %.2f MiB (%zu entities, whose last capture the next one is compared to)", capture.PropertyHistoryBytes() / s_MiB, capture.PropertyHistoryCount());
+		ImGui::Text("Decoded properties: %.2f MiB", PropertySnapshot::MaterializedBytes() / s_MiB);
+		ImGui::Text("Entity tree cache: %.2f MiB (%zu entities, reset when the scene changes or it reaches %zu)", treeCache.MemoryUsage() / s_MiB, treeCache.Size(), EntityTreeCache::EntityLimit);
+		ImGui::Separator();
+		ImGui::Text("Published snapshot: %.2f MiB", capture.SnapshotBytes() / s_MiB);
+		ImGui::Text("Interned strings: %.2f MiB", StringInterner::Global().MemoryUsage() / s_MiB);
+		ImGui::Text("Call statistics: %.2f MiB", capture.CallStatsBytes() / s_MiB);
+		const auto s_Arena = SlabArena::Global().GetStats();
+		ImGui::Text("Call arena: %.2f MiB reserved, %.1f%% of allocations off the heap (%llu reused, %llu new, %llu too large)",
+			s_Arena.slabBytes / s_MiB, s_Arena.HitRate() * 100, s_Arena.reused, s_Arena.carved, s_Arena.oversized);
+		ImGui::Text("Evicted to stay within budget: %llu pins, %llu calls", capture.EvictedPins(), capture.EvictedCalls());
+		ImGui::TextUnformatted("Only the memory above the line counts towards the budget.");
+		if (const auto s_Unmeasured = PropertySnapshot::UnmeasuredValues())
+			ImGui::Text("%zu captured property values own memory that can't be measured, only their own size is counted.", s_Unmeasured);
+		ImGui::EndTooltip();
+	}
 
+	if (capture.GetCaptureRing().Dropped() > 0) {
 		ImGui::SameLine();
-		if (ImGui::Button(frozen ? "Unfreeze" : "Freeze") && !this->haveUpdateDataAction())
-			this->updateDataAction = UpdateDataAction::ToggleFreeze;
-		ImGui::SameLine();
-		if (ImGui::Button("Clear") && !this->haveUpdateDataAction())
-			this->updateDataAction = UpdateDataAction::Clear;
-
-		ImGui::BeginChild("left pane", ImVec2(350, 0), true, ImGuiWindowFlags_HorizontalScrollbar);
+		ImGui::Text("Dropped: %llu", capture.GetCaptureRing().Dropped());
+		if (ImGui::BeginItemTooltip()) {
+			ImGui::TextUnformatted("Pin events that were discarded because the capture buffer was full before it could be processed.");
+			ImGui::EndTooltip();
+		}
+	}
 
-		if (ImGui::InputText("Filter Name", filterInput, sizeof(filterInput))) {
-			auto lock = std::unique_lock(filterInputLock);
-			filterInputSV = filterInput;
+	if (capture.StaleCalls() > 0) {
+		ImGui::SameLine();
+		ImGui::Text("Stale: %llu", capture.StaleCalls());
+		if (ImGui::BeginItemTooltip()) {
+			ImGui::TextUnformatted("Pin events that were discarded because their entity had changed type or been replaced by the time they were processed.");
+			ImGui::EndTooltip();
 		}
+	}
 
-		if (ImGui::InputText("Filter Entity Type", filterEntityInput, sizeof(filterEntityInput))) {
-			auto lock = std::unique_lock(filterEntityInputLock);
-			filterEntityInputSV = filterEntityInput;
+	if (capture.OffThreadCalls() > 0) {
+		ImGui::SameLine();
+		ImGui::Text("Off thread: %llu", capture.OffThreadCalls());
+		if (ImGui::BeginItemTooltip()) {
+			ImGui::TextUnformatted("Pin events that were discarded because they were signalled from a thread other than the game thread.");
+			ImGui::EndTooltip();
 		}
-			
-		size_t current = 0;
+	}
 
-		if (activeList.empty()) {
-			ImGui::TextUnformatted("No Data");
+	auto& rateLimiter = capture.GetRateLimiter();
+	if (const auto s_Dropped = rateLimiter.DroppedCount(); s_Dropped > 0) {
+		ImGui::SameLine();
+		ImGui::Text("Rate limited: %llu", s_Dropped);
+		if (ImGui::BeginItemTooltip()) {
+			ImGui::TextUnformatted("Pin events that were dropped for firing faster than the rate limit.");
+			ImGui::EndTooltip();
 		}
-		else {
-			for (auto it = activeList.begin(); it != activeList.end(); ++it, ++current) {
-				auto& data = *it;
-				auto title = data.name.c_str();
-
-				if (data.calls.size() > 1) {
-					titleBuff = title;
-					titleBuff += " (" + std::to_string(data.timesCalled) + ")";
-					title = titleBuff.c_str();
-				}
-				if (ImGui::Selectable(title, selected == current))
-					selected = current;
+	}
+
+	if (ImGui::InputText("Trigger", triggerInput, sizeof(triggerInput))) {
+		auto lock = std::scoped_lock(filterInputLock);
+		triggerText = triggerInput;
+		++filterInputVersion;
+	}
+	if (ImGui::BeginItemTooltip()) {
+		ImGui::TextUnformatted("Only capture calls matching this condition, checked before anything about the call is decoded. For example:");
+		ImGui::TextUnformatted("  pin == OnEnter && entityType ~ \"Trigger*\" && data.float > 0.5 && prop[\"m_bEnabled\"] == true");
+		ImGui::TextUnformatted("Tests are pin, entityType, data (the payload) and prop[\"name\"], combined with && || ! and parentheses.");
+		ImGui::TextUnformatted("data and prop take an optional .bool, .int, .float or .string suffix and compare with == != < <= > >=, or ~ and !~ to match text like the filters.");
+		ImGui::TextUnformatted("Pins are checked first and properties last, so property values are only read for calls that pass everything else.");
+		ImGui::EndTooltip();
+	}
+
+	{
+		auto lock = std::scoped_lock(filterInputLock);
+		if (!triggerError.empty())
+			ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "%s, capturing everything", triggerError.c_str());
+	}
+
+	ImGui::BeginChild("left pane", ImVec2(350, 0), true, ImGuiWindowFlags_HorizontalScrollbar);
+
+	if (ImGui::InputText("Filter Name", filterInput, sizeof(filterInput))) {
+		auto lock = std::scoped_lock(filterInputLock);
+		filterNameText = filterInput;
+		++filterInputVersion;
+	}
+	if (ImGui::BeginItemTooltip()) {
+		ImGui::TextUnformatted("Case-insensitive. Matches a part of the name, or the whole name if it contains * or ? wildcards. Prefix with re: to use a regular expression.");
+		ImGui::EndTooltip();
+	}
+
+	if (ImGui::InputText("Filter Entity Type", filterEntityInput, sizeof(filterEntityInput))) {
+		auto lock = std::scoped_lock(filterInputLock);
+		filterEntityText = filterEntityInput;
+		++filterInputVersion;
+	}
+
+	if (filterInvalid)
+		ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "Invalid regular expression");
+
+	static const char* const s_SortNames[] = { "Most recent", "Highest rate", "Most calls" };
+	ImGui::SetNextItemWidth(120);
+	ImGui::Combo("Sort", &uiPinSortOrder, s_SortNames, IM_ARRAYSIZE(s_SortNames));
+	ImGui::SameLine();
+	ImGui::SetNextItemWidth(80);
+	ImGui::InputFloat("Min Rate", &minPinRate, 0, 0, "%.1f");
+	if (ImGui::BeginItemTooltip()) {
+		ImGui::TextUnformatted("Only list pins currently firing at least this many times per second, rate limited calls included.");
+		ImGui::EndTooltip();
+	}
+
+	// Pins listed in the left pane as (index in the snapshot, rate), in display order.
+	pinOrder.clear();
+
+	for (size_t i = 0; i < activeList.size(); ++i) {
+		const auto s_Rate = snapshot->stats[i].Rate(s_StatsTime);
+		if (s_Rate >= minPinRate)
+			pinOrder.emplace_back(i, s_Rate);
+	}
+
+	if (uiPinSortOrder == static_cast<int>(PinSortOrder::Rate)) {
+		std::stable_sort(pinOrder.begin(), pinOrder.end(), [](auto& a, auto& b) { return a.second > b.second; });
+	}
+	else if (uiPinSortOrder == static_cast<int>(PinSortOrder::Calls)) {
+		std::stable_sort(pinOrder.begin(), pinOrder.end(), [&](auto& a, auto& b) {
+			return snapshot->stats[a.first].count > snapshot->stats[b.first].count;
+		});
+	}
+
+	size_t current = 0;
+
+	if (pinOrder.empty()) {
+		ImGui::TextUnformatted("No Data");
+	}
+	else {
+		for (auto it = pinOrder.begin(); it != pinOrder.end(); ++it, ++current) {
+			auto& data = *activeList[it->first];
+			auto title = SymbolStr(data.name);
+
+			if (it->second > 0) {
+				titleBuff = std::format("{} ({}, {:.1f}/s)", title, data.timesCalled, it->second);
+				title = titleBuff.c_str();
 			}
+			else if (data.calls.size() > 1) {
+				titleBuff = title;
+				titleBuff += " (" + std::to_string(data.timesCalled) + ")";
+				title = titleBuff.c_str();
+			}
+			if (ImGui::Selectable(title, selected == current))
+				selected = current;
 		}
+	}
+
+	ImGui::EndChild();
+
+	ImGui::SameLine();
 
-		ImGui::EndChild();
+	ImGui::BeginGroup();
+	ImGui::BeginChild("pin view", ImVec2(0, -ImGui::GetFrameHeightWithSpacing()));
+
+	if (!pinOrder.empty()) {
+		if (selected >= pinOrder.size())
+			selected = pinOrder.size() - 1;
+
+		const auto s_PinIndex = pinOrder[selected].first;
+		auto& pin = *activeList[s_PinIndex];
 
 		ImGui::SameLine();
 
-		ImGui::BeginGroup();
-		ImGui::BeginChild("pin view", ImVec2(0, -ImGui::GetFrameHeightWithSpacing()));
+		if (ImGui::Button("Blacklist") && !this->haveUpdateDataAction()) {
+			uiRequest.action = UpdateDataAction::Blacklist;
+			uiRequest.blacklistPin = static_cast<ZHMPin>(pin.id);
+		}
 
-		if (!activeList.empty()) {
-			auto it = activeList.begin();
-			std::advance(it, selected);
+		current = 0;
 
-			if (selected > 0 && selected >= activeList.size())
-				selected = activeList.size() - 1;
+		ImGui::TextUnformatted("Pin Name: ");
+		ImGui::SameLine();
+		ImGui::TextUnformatted(SymbolStr(pin.name));
 
-			ImGui::SameLine();
+		if (!frozen)
+			capture.SetInspectedPin(pin.id);
+
+		const auto s_TypeStats = snapshot->typeStatsPin == pin.id ? std::span(snapshot->typeStats) : std::span<const EntityTypeCallStats>();
+		this->DrawCallStats(snapshot->stats[s_PinIndex], s_TypeStats, s_StatsTime);
 
-			if (it != activeList.end() && ImGui::Button("Blacklist") && !this->haveUpdateDataAction()) {
-				this->updateDataAction = UpdateDataAction::Blacklist;
-				this->blacklistPin = static_cast<ZHMPin>(it->id);
+		ImGui::NewLine();
+		
+		auto imGuiCopyableText = [](std::string_view text, std::string_view copyText = ""sv) {
+			ImVec4 linkColor = ImVec4(0.2f, 0.6f, 1.0f, 1.0f);
+			ImGui::PushStyleColor(ImGuiCol_Text, linkColor);
+			ImGui::TextUnformatted(text.data(), text.data() + text.size());
+			ImGui::PopStyleColor();
+
+			if (ImGui::IsItemClicked()) {
+				CopyToClipboard(std::string{ copyText.empty() ? text : copyText });
 			}
+			if (ImGui::IsItemHovered()) {
+				if (copyText.size())
+					ImGui::SetTooltip("%s - click to copy", copyText.data());
+				else
+					ImGui::SetTooltip("%s", "Click to copy");
+			}
+		};
+
+		int i = 0;
 
-			auto pinIt = activeList.begin();
-			std::advance(pinIt, selected < (activeList.size() - 1) ? selected : activeList.size() - 1);
-			auto& pin = *pinIt;
-			current = 0;
+		for (auto it = pin.calls.begin(); current < std::min<size_t>(pin.calls.size(), 5) && it != pin.calls.end(); ++it, ++current) {
+			auto& call = **it;
+			auto blacklistEntityLabel = std::format("Blacklist Entity##{}", i++);
+			auto blacklistEntityTypeLabel = std::format("Blacklist Entity Type##{}", i++);
+
+			if (ImGui::Button(blacklistEntityLabel.c_str()) && !this->haveUpdateDataAction()) {
+				uiRequest.action = UpdateDataAction::BlacklistCallEntity;
+				uiRequest.blacklistPin = static_cast<ZHMPin>(pin.id);
+				uiRequest.blacklistEntityID = call.entityId;
+			}
 
-			ImGui::TextUnformatted("Pin Name: ");
 			ImGui::SameLine();
-			ImGui::TextUnformatted(pin.name.c_str());
-
-			ImGui::NewLine();
-			
-			auto imGuiCopyableText = [](std::string_view text, std::string_view copyText = ""sv) {
-				ImVec4 linkColor = ImVec4(0.2f, 0.6f, 1.0f, 1.0f);
-				ImGui::PushStyleColor(ImGuiCol_Text, linkColor);
-				ImGui::TextUnformatted(text.data(), text.data() + text.size());
-				ImGui::PopStyleColor();
-
-				if (ImGui::IsItemClicked()) {
-					CopyToClipboard(std::string{ copyText.empty() ? text : copyText });
-				}
-				if (ImGui::IsItemHovered()) {
-					if (copyText.size())
-						ImGui::SetTooltip("%s - click to copy", copyText.data());
-					else
-						ImGui::SetTooltip("%s", "Click to copy");
-				}
-			};
 
-			int i = 0;
+			if (ImGui::Button(blacklistEntityTypeLabel.c_str()) && !this->haveUpdateDataAction()) {
+				uiRequest.action = UpdateDataAction::BlacklistCallEntityType;
+				uiRequest.blacklistPin = static_cast<ZHMPin>(pin.id);
+				uiRequest.blacklistEntityType = call.entityTree->typeId;
+			}
 
-			for (auto it = pin.calls.begin(); current < std::min<size_t>(pin.calls.size(), 5) && it != pin.calls.end(); ++it, ++current) {
-				auto blacklistEntityLabel = std::format("Blacklist Entity##{}", i++);
-				auto blacklistEntityTypeLabel = std::format("Blacklist Entity Type##{}", i++);
+			ImGui::TextUnformatted("Data: ");
+			ImGui::SameLine();
+			ImGui::TextUnformatted(call.data.c_str());
 
-				if (ImGui::Button(blacklistEntityLabel.c_str()) && !this->haveUpdateDataAction()) {
-					this->updateDataAction = UpdateDataAction::BlacklistCallEntity;
-					this->blacklistPin = static_cast<ZHMPin>(pin.id);
-					this->blacklistEntityID = it->entityId;
-				}
+			ImGui::TextUnformatted("Entity ID:");
+			ImGui::SameLine(0, 1.0);
+			const auto entityIdText = std::format("{:016x}", call.entityId);
+			imGuiCopyableText(entityIdText);
 
-				ImGui::SameLine();
+			ImGui::Text("Entity Name: %s", SymbolStr(call.entityName));
+			ImGui::Text("Entity Type: %s", call.entityType == 0 ? "(none)" : SymbolStr(call.entityType));
 
-				if (ImGui::Button(blacklistEntityTypeLabel.c_str()) && !this->haveUpdateDataAction()) {
-					this->updateDataAction = UpdateDataAction::BlacklistCallEntityType;
-					this->blacklistPin = static_cast<ZHMPin>(pin.id);
-					this->blacklistEntityTypeName = it->entityType;
+			ImGui::TextUnformatted("Entity Tree:");
+			treePath.clear();
+			for (auto node = call.entityTree.get(); node; node = node->parent.get())
+				treePath.push_back(node);
+			for (auto nodeIt = treePath.rbegin(); nodeIt != treePath.rend(); ++nodeIt) {
+				ImGui::SameLine(0, 1.0);
+				if (nodeIt != treePath.rbegin()) {
+					ImGui::TextUnformatted(">");
+					ImGui::SameLine(0, 1.0);
 				}
+				const auto nodeIdText = std::format("{:016x}", (*nodeIt)->entityId);
+				imGuiCopyableText(SymbolView((*nodeIt)->name), nodeIdText);
+			}
 
-				auto& call = *it;
+			ImGui::TextUnformatted("Entity Props");
 
-				ImGui::TextUnformatted("Data: ");
-				ImGui::SameLine();
-				ImGui::TextUnformatted(call.data.c_str());
+			ImGui::Indent(20);
+			if (call.props)
+				displayProperties(call.props->Materialize());
+			ImGui::Unindent(20);
 
-				ImGui::TextUnformatted("Entity ID:");
-				ImGui::SameLine(0, 1.0);
-				imGuiCopyableText(call.entityId);
+			ImGui::Separator();
+		}
+	}
 
-				ImGui::Text("Entity Name: %s", call.entityName.c_str());
-				ImGui::Text("Entity Type: %s", call.entityType.empty() ? "(none)" : call.entityType.c_str());
+	ImGui::EndChild();
+	ImGui::EndGroup();
+}
 
-				ImGui::TextUnformatted("Entity Tree:");
-				for (size_t i = 0; i < call.entityTree.size(); ++i) {
-					ImGui::SameLine(0, 1.0);
-					if (i != 0) {
-						ImGui::TextUnformatted(">");
-						ImGui::SameLine(0, 1.0);
-					}
-					imGuiCopyableText(call.entityTree[i].name, call.entityTree[i].id);
-				}
+void PinCushion::DrawCallStats(const CallStats& stats, std::span<const EntityTypeCallStats> typeStats, std::chrono::steady_clock::time_point now) {
+	const auto s_SecondsAgo = [&](std::chrono::steady_clock::time_point time) {
+		return std::chrono::duration<double>(now - time).count();
+	};
 
-				ImGui::TextUnformatted("Entity Props");
+	if (stats.count == 0) {
+		ImGui::TextDisabled("No call statistics");
+		return;
+	}
 
-				ImGui::Indent(20);
-				displayProperties(call);
-				ImGui::Unindent(20);
+	ImGui::Text("Rate: %.2f/s, %llu calls, first %.1fs ago, last %.1fs ago", stats.Rate(now), stats.count, s_SecondsAgo(stats.firstSeen), s_SecondsAgo(stats.lastSeen));
 
-				ImGui::Separator();
-			}
+	if (stats.count < 2)
+		return;
+
+	ImGui::Text("Interval: min %.3fms, mean %.3fms, max %.3fms", stats.MinInterval() / 1e6, stats.MeanInterval() / 1e6, stats.maxInterval / 1e6);
+
+	// Plotted up to the longest interval seen rather than across all the empty buckets above it.
+	float intervals[CallStats::IntervalBuckets];
+	const auto s_Buckets = CallStats::BucketFor(stats.maxInterval) + 1;
+	for (size_t i = 0; i < s_Buckets; ++i)
+		intervals[i] = static_cast<float>(stats.intervals[i]);
+	ImGui::PlotHistogram("Intervals", intervals, static_cast<int>(s_Buckets), 0, nullptr, 0, FLT_MAX, ImVec2(0, 60));
+	if (ImGui::BeginItemTooltip()) {
+		ImGui::TextUnformatted("Time between calls, each bar twice as long as the previous one: under 1us, under 2us, under 4us and so on.");
+		ImGui::EndTooltip();
+	}
+
+	if (typeStats.empty() || !ImGui::TreeNode("By entity type"))
+		return;
+
+	if (ImGui::BeginTable("TypeStats", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingStretchProp)) {
+		ImGui::TableSetupColumn("Entity Type");
+		ImGui::TableSetupColumn("Rate (/s)");
+		ImGui::TableSetupColumn("Calls");
+		ImGui::TableSetupColumn("Mean Interval (ms)");
+		ImGui::TableHeadersRow();
+
+		for (auto& entry : typeStats) {
+			ImGui::TableNextRow();
+			ImGui::TableNextColumn();
+			ImGui::TextUnformatted(SymbolStr(entry.entityType));
+			ImGui::TableNextColumn();
+			ImGui::Text("%.2f", entry.stats.Rate(now));
+			ImGui::TableNextColumn();
+			ImGui::Text("%llu", entry.stats.count);
+			ImGui::TableNextColumn();
+			ImGui::Text("%.3f", entry.stats.MeanInterval() / 1e6);
 		}
 
-		ImGui::EndChild();
-		ImGui::EndGroup();
+		ImGui::EndTable();
 	}
-	ImGui::End();
-	ImGui::PopStyleVar();
+
+	ImGui::TreePop();
+}
+
+void PinCushion::DrawHotPinsTab(const DrawState& state) {
+	const auto snapshot = state.frozenSnapshot ? state.frozenSnapshot : capture.GetSnapshot();
+
+	if (!snapshot || snapshot->hotPins.empty()) {
+		ImGui::TextUnformatted("No Data");
+		return;
+	}
+
+	ImGui::Text("Busiest pin and entity pairs out of %llu calls since the pins were last cleared.", snapshot->hotPinsTotal);
+	if (snapshot->hotPinsMaxError > 0) {
+		ImGui::SameLine();
+		ImGui::TextDisabled("Pairs not listed: at most %llu calls each.", snapshot->hotPinsMaxError);
+	}
+	if (ImGui::BeginItemTooltip()) {
+		ImGui::Text("Counts are approximate once more than %zu pairs have been seen. Each count may be too high by up to its error, never too low. Rate limited calls are included.", PinCapture::HotPinCapacity);
+		if (const auto s_Missed = capture.MissedCallEvents())
+			ImGui::Text("%llu calls weren't counted because more than %zu arrived within a frame.", s_Missed, PinCapture::CallEventCapacity);
+		ImGui::EndTooltip();
+	}
+
+	if (!ImGui::BeginTable("HotPins", 7, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingStretchProp | ImGuiTableFlags_ScrollY))
+		return;
+
+	ImGui::TableSetupScrollFreeze(0, 1);
+	ImGui::TableSetupColumn("Pin");
+	ImGui::TableSetupColumn("Entity ID");
+	ImGui::TableSetupColumn("Entity Type");
+	ImGui::TableSetupColumn("Calls");
+	ImGui::TableSetupColumn("Error");
+	ImGui::TableSetupColumn("Share");
+	ImGui::TableSetupColumn("");
+	ImGui::TableHeadersRow();
+
+	int i = 0;
+
+	for (auto& hotPin : snapshot->hotPins) {
+		ImGui::TableNextRow();
+		ImGui::TableNextColumn();
+		ImGui::TextUnformatted(SymbolStr(hotPin.pinName));
+		ImGui::TableNextColumn();
+		ImGui::Text("%016llx", hotPin.entityId);
+		ImGui::TableNextColumn();
+		ImGui::TextUnformatted(SymbolStr(hotPin.entityType));
+		ImGui::TableNextColumn();
+		ImGui::Text("%llu", hotPin.count);
+		ImGui::TableNextColumn();
+		ImGui::Text("%llu", hotPin.error);
+		ImGui::TableNextColumn();
+		ImGui::Text("%.1f%%", 100.0 * hotPin.count / snapshot->hotPinsTotal);
+		ImGui::TableNextColumn();
+
+		const auto s_Label = std::format("Blacklist Entity##hot{}", i++);
+		if (ImGui::SmallButton(s_Label.c_str()) && !this->haveUpdateDataAction()) {
+			uiRequest.action = UpdateDataAction::BlacklistCallEntity;
+			uiRequest.blacklistPin = static_cast<ZHMPin>(hotPin.pinId);
+			uiRequest.blacklistEntityID = hotPin.entityId;
+		}
+	}
+
+	ImGui::EndTable();
+}
+
+void PinCushion::DrawPerfTab() {
+	auto& perf = capture.GetPerfStats();
+	const auto s_TicksPerMicro = PerfClock::TicksPerSecond() / 1e6;
+	const auto s_Now = std::chrono::steady_clock::now();
+	const auto s_HookCount = perf.Get(PerfStage::Hook).Summarize().count;
+	const auto s_QueuedCount = perf.Get(PerfStage::HookEnqueue).Summarize().count;
+
+	// Rates are worked out from the counts once a second rather than tracked by the hook.
+	const auto s_RateSeconds = std::chrono::duration<double>(s_Now - perfRateTime).count();
+	if (s_RateSeconds >= 1.0) {
+		hookCallsPerSecond = s_HookCount >= perfRateHookCount ? (s_HookCount - perfRateHookCount) / s_RateSeconds : 0;
+		queuedCallsPerSecond = s_QueuedCount >= perfRateQueuedCount ? (s_QueuedCount - perfRateQueuedCount) / s_RateSeconds : 0;
+		perfRateHookCount = s_HookCount;
+		perfRateQueuedCount = s_QueuedCount;
+		perfRateTime = s_Now;
+	}
+
+	auto enabled = perf.IsEnabled();
+	if (ImGui::Checkbox("Collect Timings", &enabled))
+		perf.SetEnabled(enabled);
+	if (ImGui::BeginItemTooltip()) {
+		ImGui::TextUnformatted("Only one in 16 hook calls is timed and counts for the others, which keeps the cost to a few clock reads per 16 pin calls. Turn this off to remove that overhead too.");
+		ImGui::EndTooltip();
+	}
+	ImGui::SameLine();
+	if (ImGui::Button("Reset Timings") && !this->haveUpdateDataAction())
+		uiRequest.action = UpdateDataAction::ResetPerf;
+	ImGui::SameLine();
+	ImGui::Text("Hook calls: %.0f/s, queued: %.0f/s", hookCallsPerSecond, queuedCallsPerSecond);
+
+	if (!ImGui::BeginTable("Perf", 6, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingStretchProp))
+		return;
+
+	ImGui::TableSetupColumn("Stage");
+	ImGui::TableSetupColumn("Count");
+	ImGui::TableSetupColumn("p50 (us)");
+	ImGui::TableSetupColumn("p99 (us)");
+	ImGui::TableSetupColumn("Max (us)");
+	ImGui::TableSetupColumn("Mean (us)");
+	ImGui::TableHeadersRow();
+
+	for (size_t i = 0; i < PerfStats::StageCount; ++i) {
+		const auto s_Stage = static_cast<PerfStage>(i);
+		const auto s_Summary = perf.Get(s_Stage).Summarize();
+
+		ImGui::TableNextRow();
+		ImGui::TableNextColumn();
+		ImGui::TextUnformatted(PerfStats::StageName(s_Stage));
+		ImGui::TableNextColumn();
+		ImGui::Text("%llu", s_Summary.count);
+		ImGui::TableNextColumn();
+		ImGui::Text("%.2f", s_Summary.Quantile(0.5) / s_TicksPerMicro);
+		ImGui::TableNextColumn();
+		ImGui::Text("%.2f", s_Summary.Quantile(0.99) / s_TicksPerMicro);
+		ImGui::TableNextColumn();
+		ImGui::Text("%.2f", s_Summary.max / s_TicksPerMicro);
+		ImGui::TableNextColumn();
+		ImGui::Text("%.2f", s_Summary.Mean() / s_TicksPerMicro);
+	}
+
+	ImGui::EndTable();
 }
 
 void PinCushion::OnFrameUpdate(const SGameUpdateEvent &p_UpdateEvent) {
-	if (this->haveUpdateDataAction()) {
+	auto& perf = capture.GetPerfStats();
+	PerfScope s_FrameScope(perf, PerfStage::Frame);
+	PerfScope s_ActionScope(perf, PerfStage::FrameActions);
+
+	perf.RecordHookFrame();
+
+	if (requestPending.load(std::memory_order_acquire)) {
 		auto lock = std::unique_lock(displayDataLock);
-		if (uiRateLimit != rateLimit)
-			rateLimit = uiRateLimit;
-		switch (this->getUpdateDataAction()) {
+		const auto& request = pendingRequest;
+		capture.SetRateLimit(request.enableRateBlock, static_cast<float>(request.rateLimit), static_cast<uint32>(request.sampleRate));
+		capture.SetHistoryLimit(request.historyLimit);
+		capture.SetPinLimit(request.pinLimit);
+		capture.SetMemoryBudget(static_cast<size_t>(request.memoryBudget) * 1024 * 1024);
+		switch (request.action) {
 		case UpdateDataAction::Clear:
-			pinData.clear();
+			capture.ClearPins();
 			break;
 		case UpdateDataAction::Blacklist: {
-			pinBlacklist.insert(blacklistPin);
-			auto it = std::find_if(pinData.begin(), pinData.end(), [this](const PinData& v) { return static_cast<ZHMPin>(v.id) == this->blacklistPin; });
-			if (it != pinData.end())
-				pinData.erase(it);
-			auto displayIt = std::find_if(displayPinData.begin(), displayPinData.end(), [this](const PinData& v) { return static_cast<ZHMPin>(v.id) == this->blacklistPin; });
-			if (displayIt != displayPinData.end())
-				displayPinData.erase(displayIt);
-			auto frozenIt = std::find_if(frozenPinData.begin(), frozenPinData.end(), [this](const PinData& v) { return static_cast<ZHMPin>(v.id) == this->blacklistPin; });
-			if (frozenIt != frozenPinData.end())
-				frozenPinData.erase(frozenIt);
+			capture.BlacklistPin(static_cast<uint32>(request.blacklistPin));
+
+			// The frozen snapshot can't be edited, so it is replaced by a copy of its pin pointers without this one.
+			if (frozenSnapshot) {
+				auto unfrozen = std::make_shared<PinSnapshot>();
+				unfrozen->time = frozenSnapshot->time;
+				unfrozen->typeStatsPin = frozenSnapshot->typeStatsPin;
+				unfrozen->typeStats = frozenSnapshot->typeStats;
+				unfrozen->hotPinsTotal = frozenSnapshot->hotPinsTotal;
+				unfrozen->hotPinsMaxError = frozenSnapshot->hotPinsMaxError;
+				for (size_t i = 0; i < frozenSnapshot->pins.size(); ++i) {
+					if (static_cast<ZHMPin>(frozenSnapshot->pins[i]->id) != request.blacklistPin) {
+						unfrozen->pins.push_back(frozenSnapshot->pins[i]);
+						unfrozen->stats.push_back(frozenSnapshot->stats[i]);
+					}
+				}
+				for (const auto& hotPin : frozenSnapshot->hotPins) {
+					if (static_cast<ZHMPin>(hotPin.pinId) != request.blacklistPin)
+						unfrozen->hotPins.push_back(hotPin);
+				}
+				frozenSnapshot = std::move(unfrozen);
+			}
 			break;
 		}
 		case UpdateDataAction::BlacklistCallEntity: {
-			pinCallEntityIDBlacklist.emplace(blacklistPin, blacklistEntityID);
+			capture.BlacklistEntity(static_cast<uint32>(request.blacklistPin), request.blacklistEntityID);
 			break;
 		}
 		case UpdateDataAction::BlacklistCallEntityType: {
-			pinCallEntityNameBlacklist.emplace(blacklistPin, blacklistEntityTypeName);
+			capture.BlacklistEntityType(static_cast<uint32>(request.blacklistPin), request.blacklistEntityType);
 			break;
 		}
 		case UpdateDataAction::ClearBlacklist:
-			pinBlacklist.clear();
-			pinCallEntityIDBlacklist.clear();
-			pinCallEntityNameBlacklist.clear();
+			capture.ClearBlacklists();
 			break;
-		case UpdateDataAction::ToggleFreeze:
-			if (!frozenPinData.empty())
-				frozenPinData.clear();
+		case UpdateDataAction::ToggleFreeze: {
+			if (frozenSnapshot)
+				frozenSnapshot.reset();
+			else if (auto snapshot = capture.GetSnapshot())
+				frozenSnapshot = std::move(snapshot);
 			else
-				std::copy(displayPinData.begin(), displayPinData.end(), std::back_inserter(frozenPinData));
+				frozenSnapshot = std::make_shared<PinSnapshot>();
 			break;
 		}
+		case UpdateDataAction::ToggleRecording:
+			if (capture.GetCaptureWriter().IsOpen()) {
+				capture.StopRecording();
+				if (capture.GetCaptureWriter().Failed())
+					Logger::Error("PinCushion: writing {} failed, the capture is incomplete.", capture.GetCaptureWriter().GetPath().string());
+			}
+			else {
+				const auto s_Time = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+				if (!capture.StartRecording(std::format("PinCushion_{}.pincap", s_Time)))
+					Logger::Error("PinCushion: failed to open capture file for recording.");
+			}
+			break;
+		case UpdateDataAction::ExportJson: {
+			const auto s_Snapshot = frozenSnapshot ? frozenSnapshot : capture.GetSnapshot();
+			if (!s_Snapshot) break;
 
-		this->updateDataAction = UpdateDataAction::None;
-	}
-
-	auto now = std::chrono::system_clock::now();
-	if (this->enableRateBlock) {
-		auto secs = std::chrono::duration<double>(now - this->lastCleanupTime).count();
-
-		if (secs >= 3) {
-			for (auto freqIt = pinCallFrequency.begin(); freqIt != pinCallFrequency.end(); ++freqIt) {
-				if (freqIt->second < static_cast<uint64>(secs / 3) * rateLimit) continue;
-
-				auto it = std::find_if(this->pinData.begin(), this->pinData.end(), [freqIt](const PinData& v) { return static_cast<ZHMPin>(v.id) == freqIt->first.first; });
-				if (it != this->pinData.end()) {
-					for (auto callIt = it->calls.begin(); callIt != it->calls.end(); ) {
-						if (callIt->entityType != freqIt->first.second) {
-							++callIt;
-							continue;
-						}
-
-						callIt = it->calls.erase(callIt);
-					}
-
-					if (it->calls.empty())
-						this->pinData.erase(it);
-				}
-
-				this->pinCallEntityNameBlacklist.insert(freqIt->first);
-				freqIt = pinCallFrequency.erase(freqIt);
-				if (freqIt == pinCallFrequency.end()) break;
+			if (exportTask.valid() && exportTask.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+				Logger::Error("PinCushion: still writing the previous export.");
+				break;
 			}
 
-			this->lastCleanupTime = now;
-			this->lastFreqPruneTime = secs;
+			const auto s_Time = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+			auto s_Path = std::format("PinCushion_{}.ndjson", s_Time);
+			std::string s_Text;
+			const auto s_Count = FormatCallsJson(*s_Snapshot, s_Text);
+
+			// Only the formatting needs the lock, the file is written on its own thread.
+			exportTask = std::async(std::launch::async, [s_Path = std::move(s_Path), s_Text = std::move(s_Text), s_Count] {
+				if (WriteCallsJson(s_Path, s_Text))
+					Logger::Info("PinCushion: exported {} calls to {}.", s_Count, s_Path);
+				else
+					Logger::Error("PinCushion: failed to write {}.", s_Path);
+			});
+			break;
 		}
+		case UpdateDataAction::ResetPerf:
+			perf.Reset();
+			break;
+		}
+
+		requestPending.store(false, std::memory_order_release);
 	}
 
+	this->ApplyFilterInput();
+	s_ActionScope.Stop();
+
+	const auto s_SceneCtx = Globals::Hitman5Module->m_pEntitySceneContext;
+	capture.Update(s_SceneCtx ? s_SceneCtx->m_pScene : nullptr);
+
+	auto now = std::chrono::system_clock::now();
+
 	auto secsSinceUpdate = std::chrono::duration<double>(now - this->lastDisplayUpdateTime).count();
 	if (secsSinceUpdate > .15) {
-		auto lock = std::unique_lock(displayDataLock);
-		auto filterLock = std::shared_lock(filterInputLock);
-		this->displayPinData.clear();
-		for (auto& data : this->pinData) {
-			auto filterThisPin = (!filterInputSV.empty() && !data.name.contains(filterInputSV));
-			if (filterThisPin) continue;
-			this->displayPinData.push_back(data);
-		}
+		PerfScope s_PublishScope(perf, PerfStage::FramePublish);
+		capture.PublishSnapshot();
 		this->lastDisplayUpdateTime = now;
 	}
 }
 
-DEFINE_PLUGIN_DETOUR(PinCushion, bool, OnPinOutput, ZEntityRef entity, uint32 pinId, const ZObjectRef& data) {
+void PinCushion::ApplyFilterInput() {
+	const auto version = filterInputVersion.load();
+	if (version == appliedFilterVersion) return;
+
+	auto lock = std::scoped_lock(filterInputLock);
+
+	filterInvalid = !capture.SetFilters(filterNameText, filterEntityText);
+	triggerError = capture.SetTrigger(triggerText) ? "" : capture.GetTriggerError();
+	appliedFilterVersion = version;
+}
+
+auto PinCushion::GetPinName(uint32 pinId) -> Symbol {
 	static ZString zPinName;
 
-	if (!m_ShowMessage || pinBlacklist.contains(static_cast<ZHMPin>(pinId)) || permaBlacklist.contains(pinId))
-		return HookAction::Continue();
+	zPinName = "";
+	return SDK()->GetPinName(pinId, zPinName) ? Intern(zPinName.ToStringView()) : Intern(std::to_string(pinId));
+}
 
-	PinCallData callData;
+// Pin IDs are the CRC-32 of the pin's name.
+static auto Crc32(std::string_view p_Text) -> uint32 {
+	uint32 crc = ~0u;
 
-	ZObjectRefToString(data, callData.data);
+	for (const auto c : p_Text) {
+		crc ^= static_cast<uint8>(c);
+		for (int i = 0; i < 8; ++i)
+			crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1)));
+	}
 
-	const auto s_SceneCtx = Globals::Hitman5Module->m_pEntitySceneContext;
-	if (!s_SceneCtx || !s_SceneCtx->m_pScene) return HookAction::Continue();
+	return ~crc;
+}
+
+auto PinCushion::GetPinId(std::string_view name) -> std::optional<uint32> {
+	// Only names the SDK knows are accepted, so a typo doesn't silently match nothing.
+	const auto s_PinId = Crc32(name);
+	ZString s_PinName;
 
-	auto s_EntityType = entity->GetType();
+	if (!SDK()->GetPinName(s_PinId, s_PinName) || s_PinName.ToStringView() != name)
+		return std::nullopt;
+	return s_PinId;
+}
 
+auto PinCushion::GetEntityName(ZEntityRef entity) -> Symbol {
 	// The way to get the factory here is probably wrong.
 	auto s_Factory = reinterpret_cast<ZTemplateEntityBlueprintFactory*>(entity.GetBlueprintFactory());
 
@@ -631,169 +1015,21 @@ DEFINE_PLUGIN_DETOUR(PinCushion, bool, OnPinOutput, ZEntityRef entity, uint32 pi
 		auto s_Index = s_Factory->GetSubEntityIndex(entity->GetType()->m_nEntityId);
 
 		if (s_Index != -1 && s_Factory->m_pTemplateEntityBlueprint)
-			callData.entityName = s_Factory->m_pTemplateEntityBlueprint->subEntities[s_Index].entityName;
+			return Intern(s_Factory->m_pTemplateEntityBlueprint->subEntities[s_Index].entityName.ToStringView());
 	}
 
-	const auto& s_Interfaces = *entity->GetType()->m_pInterfaces;
-	callData.entityId = fmt::format("{:016x}", entity->GetType()->m_nEntityId);
-	callData.entityType = s_Interfaces[0].m_pTypeId->typeInfo()->m_pTypeName;
-	callData.entityTree = getEntityTree(entity);
+	return 0;
+}
 
-	if (pinCallEntityNameBlacklist.contains(std::make_pair(static_cast<ZHMPin>(pinId), callData.entityType))) {
-		return HookAction::Continue();
-	}
-	if (pinCallEntityIDBlacklist.contains(std::make_pair(static_cast<ZHMPin>(pinId), callData.entityId))) {
+DEFINE_PLUGIN_DETOUR(PinCushion, bool, OnPinOutput, ZEntityRef entity, uint32 pinId, const ZObjectRef& data) {
+	if (!m_ShowMessage || s_PermaBlacklist.Contains(pinId))
 		return HookAction::Continue();
-	}
-
-	if (s_EntityType && s_EntityType->m_pProperties01) {
-		for (uint32_t i = 0; i < s_EntityType->m_pProperties01->size(); ++i) {
-			ZEntityProperty* s_Property = &s_EntityType->m_pProperties01->operator[](i);
-			if (!s_Property->m_pType)
-				continue;
-
-			const auto* s_PropertyInfo = s_Property->m_pType->getPropertyInfo();
-
-			if (!s_PropertyInfo || !s_PropertyInfo->m_pType)
-				continue;
-
-			const auto s_PropertyAddress = reinterpret_cast<uintptr_t>(entity.m_pEntity) + s_Property->m_nOffset;
-			const auto s_PropertyType = s_PropertyInfo->m_pType;
-			const auto s_TypeInfo = s_PropertyType->typeInfo();
-			const uint16_t s_TypeSize = s_TypeInfo->m_nTypeSize;
-			const uint16_t s_TypeAlignment = s_TypeInfo->m_nTypeAlignment;
-
-			auto* s_Data = (*Globals::MemoryManager)->m_pNormalAllocator->AllocateAligned(s_TypeSize, s_TypeAlignment);
 
-			if (s_PropertyInfo->m_nFlags & EPropertyInfoFlags::E_HAS_GETTER_SETTER)
-				s_PropertyInfo->get(reinterpret_cast<void*>(s_PropertyAddress), s_Data, s_PropertyInfo->m_nOffset);
-			else
-				s_TypeInfo->m_pTypeFunctions->copyConstruct(s_Data, reinterpret_cast<void*>(s_PropertyAddress));
-
-			const std::string s_TypeName = s_TypeInfo->m_pTypeName;
-			const std::string s_InputId = std::format("##Property{}", i);
-
-			PropertyInfo prop;
-
-			if (s_TypeName == "ZString")
-				prop = Properties::StringProperty(s_PropertyType, s_Data);
-			else if (s_TypeName == "bool")
-				prop = Properties::BoolProperty(s_PropertyType, s_Data);
-			else if (s_TypeName == "uint8")
-				prop = Properties::Uint8Property(s_PropertyType, s_Data);
-			else if (s_TypeName == "int8")
-				prop = Properties::Int8Property(s_PropertyType, s_Data);
-			else if (s_TypeName == "uint16")
-				prop = Properties::Uint16Property(s_PropertyType, s_Data);
-			else if (s_TypeName == "int16")
-				prop = Properties::Int16Property(s_PropertyType, s_Data);
-			else if (s_TypeName == "uint32")
-				prop = Properties::Uint32Property(s_PropertyType, s_Data);
-			else if (s_TypeName == "int32")
-				prop = Properties::Int32Property(s_PropertyType, s_Data);
-			else if (s_TypeName == "uint64")
-				prop = Properties::Uint64Property(s_PropertyType, s_Data);
-			else if (s_TypeName == "int64")
-				prop = Properties::Int64Property(s_PropertyType, s_Data);
-			else if (s_TypeName == "float32")
-				prop = Properties::Float32Property(s_PropertyType, s_Data);
-			else if (s_TypeName == "float64")
-				prop = Properties::Float64Property(s_PropertyType, s_Data);
-			else if (s_TypeName == "SVector2")
-				prop = Properties::SVector2Property(s_PropertyType, s_Data);
-			else if (s_TypeName == "SVector3")
-				prop = Properties::SVector3Property(s_PropertyType, s_Data);
-			else if (s_TypeName == "SVector4")
-				prop = Properties::SVector4Property(s_PropertyType, s_Data);
-			else if (s_TypeName == "SMatrix43")
-				prop = Properties::SMatrix43Property(s_PropertyType, s_Data);
-			else if (s_TypeName == "SColorRGB")
-				prop = Properties::SColorRGBProperty(s_PropertyType, s_Data);
-			else if (s_TypeName == "SColorRGBA")
-				prop = Properties::SColorRGBAProperty(s_PropertyType, s_Data);
-			else if (s_TypeName == "ZRepositoryID")
-				prop = Properties::ZRepositoryIDProperty(s_PropertyType, static_cast<ZRepositoryID*>(s_Data));
-			else if (s_TypeName == "ZDynamicObject")
-				prop = Properties::ZDynamicObjectProperty(s_PropertyType, static_cast<ZDynamicObject*>(s_Data));
-			else if (s_PropertyInfo->m_pType->typeInfo()->isEnum())
-				prop = Properties::EnumProperty(s_PropertyType, s_Data);
-			else if (s_PropertyInfo->m_pType->typeInfo()->isResource())
-				prop = Properties::ResourceProperty(s_PropertyType, s_Data);
-			//else if (s_TypeName.starts_with("TEntityRef<"))
-			//	Properties::TEntityRefProperty(s_InputId, s_Entity, s_Property, s_Data);
-			else
-				prop = Properties::UnsupportedProperty(s_PropertyType, s_Data);
-
-			prop.typeName = s_TypeName;
-			prop.inputId = s_InputId;
-
-			(*Globals::MemoryManager)->m_pNormalAllocator->Free(s_Data);
-
-			prop.hasNoDirectName = s_PropertyInfo->m_pType->typeInfo()->isResource() || s_PropertyInfo->m_nPropertyID != s_Property->m_nPropertyId;
-			if (prop.hasNoDirectName) {
-				const auto s_PropertyName = HM3_GetPropertyName(s_Property->m_nPropertyId);
-
-				prop.name = s_PropertyName.Size > 0
-					? std::string(s_PropertyName.Data, s_PropertyName.Size)
-					: std::format("~{:#08x}", s_Property->m_nPropertyId);
-			}
-			else prop.name = s_PropertyInfo->m_pName;
-
-			callData.props.push_back(std::move(prop));
-		}
-	}
-
-	if (this->enableRateBlock) {
-		auto freqIt = pinCallFrequency.find(std::make_pair(static_cast<ZHMPin>(pinId), callData.entityType));
-		if (freqIt == pinCallFrequency.end()) pinCallFrequency.emplace(std::make_pair(static_cast<ZHMPin>(pinId), callData.entityType), 1);
-		else ++freqIt->second;
-	}
-
-	auto lastPin = getRecentPinIterator(pinId);
-
-	if (lastPin != pinData.end()) {
-		auto addThisCall = true;
-		{
-			auto filterEntityLock = std::shared_lock(filterEntityInputLock);
-			if (!filterEntityInputSV.empty() && !callData.entityType.contains(filterEntityInputSV))
-				addThisCall = false;
-		}
-
-		if (addThisCall) {
-			++lastPin->timesCalled;
-
-			lastPin->calls.push_front(std::move(callData));
-			if (lastPin->calls.size() > 10)
-				lastPin->calls.resize(10);
-
-			if (lastPin != pinData.begin()) {
-				pinData.push_front(std::move(*lastPin));
-				pinData.erase(lastPin);
-			}
-		}
-
-		return HookAction::Continue();
-	}
+	const auto s_SceneCtx = Globals::Hitman5Module->m_pEntitySceneContext;
+	if (!s_SceneCtx || !s_SceneCtx->m_pScene) return HookAction::Continue();
 
-	zPinName = "";
-	auto name = SDK()->GetPinName(pinId, zPinName) ? std::string(zPinName) : std::to_string(pinId);
-	auto addThisPin = false;
-	{
-		auto lock = std::shared_lock(filterInputLock);
-		auto filterEntityLock = std::shared_lock(filterEntityInputLock);
-		addThisPin = (filterInputSV.empty() || name.contains(filterInputSV))
-			&& (filterEntityInputSV.empty() || callData.entityType.contains(filterEntityInputSV));
-	}
+	capture.OnPinOutput(entity, pinId, data);
 
-	if (addThisPin) {
-		PinData pin;
-		pin.id = pinId;
-		pin.name = name;
-		pin.calls.push_front(std::move(callData));
-		pinData.push_front(std::move(pin));
-		if (pinData.size() > 200)
-			pinData.resize(200);
-	}
 	return HookAction::Continue();
 }
 
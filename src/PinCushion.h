@@ -1,5 +1,6 @@
 #pragma once
 #define NOMINMAX
+#include "PinCapture.h"
 #include "Properties.h"
 #include <IPluginInterface.h>
 #include <Glacier/Pins.h>
@@ -7,13 +8,17 @@
 #include <Glacier/ZEntity.h>
 #include <Glacier/ZGameContext.h>
 #include <Glacier/ZObject.h>
+#include <Glacier/ZScene.h>
 #include <atomic>
 #include <chrono>
-#include <list>
+#include <future>
+#include <memory>
 #include <mutex>
+#include <optional>
 #include <shared_mutex>
-#include <set>
+#include <span>
 #include <string>
+#include <string_view>
 
 #ifdef max
 #undef max
@@ -31,32 +36,6 @@
 #undef MIN
 #endif
 
-struct NameIDPair {
-	std::string id;
-	std::string name;
-
-	NameIDPair() = default;
-	NameIDPair(std::string id, std::string name) : id(id), name(name) {}
-};
-
-struct PinCallData {
-	std::string entityId;
-	std::string entityName;
-	std::string entityType;
-	std::vector<NameIDPair> entityTree;
-	std::string data;
-	std::vector<PropertyInfo> props;
-};
-
-struct PinData {
-	uint32 id = -1;
-	uint32 lastCheckedTimesCalled = 0;
-	uint64 timesCalled = 1;
-	double checkedDelta = 0;
-	std::string name;
-	std::list<PinCallData> calls;
-};
-
 enum class UpdateDataAction {
 	None,
 	Blacklist,
@@ -65,10 +44,37 @@ enum class UpdateDataAction {
 	Clear,
 	ClearBlacklist,
 	ToggleFreeze,
+	ToggleRecording,
+	ExportJson,
 	RateLimit,
+	SampleRate,
+	PinLimit,
+	HistoryLimit,
+	MemoryBudget,
+	ResetPerf,
 };
 
-class PinCushion : public IPluginInterface {
+// What the UI asks OnFrameUpdate to do, along with the settings that are applied with every action.
+struct UpdateDataRequest {
+	UpdateDataAction action = UpdateDataAction::None;
+	ZHMPin blacklistPin = static_cast<ZHMPin>(0);
+	uint64 blacklistEntityID = 0;
+	STypeID* blacklistEntityType = nullptr;
+	bool enableRateBlock = true;
+	int rateLimit = 15;
+	int sampleRate = 0;
+	int historyLimit = 10;
+	int pinLimit = 200;
+	int memoryBudget = 64;
+};
+
+enum class PinSortOrder {
+	Recent,
+	Rate,
+	Calls,
+};
+
+class PinCushion : public IPluginInterface, public IPinCaptureHost {
 public:
 	void OnEngineInitialized() override;
 	PinCushion();
@@ -77,53 +83,74 @@ public:
 	void OnDrawUI(bool p_HasFocus) override;
 
 private:
+	// What the UI draws that OnFrameUpdate changes, copied under displayDataLock before drawing.
+	struct DrawState {
+		std::shared_ptr<const PinSnapshot> frozenSnapshot;
+		std::string recordingPath;
+		size_t memoryBudget = 0;
+	};
+
+	void DrawPinsTab(const DrawState& state);
+	void DrawHotPinsTab(const DrawState& state);
+	void DrawPerfTab();
+	// Hands the UI's request over to OnFrameUpdate once it has taken the previous one.
+	void SubmitRequest();
+	void DrawCallStats(const CallStats& stats, std::span<const EntityTypeCallStats> typeStats, std::chrono::steady_clock::time_point now);
 	void OnFrameUpdate(const SGameUpdateEvent& p_UpdateEvent);
+	void ApplyFilterInput();
+	auto GetPinName(uint32 pinId) -> Symbol override;
+	auto GetEntityName(ZEntityRef entity) -> Symbol override;
+	auto GetPinId(std::string_view name) -> std::optional<uint32> override;
 	//DECLARE_PLUGIN_DETOUR(PinCushion, void, OnLoadScene, ZEntitySceneContext* th, ZSceneData& p_SceneData);
 	DECLARE_PLUGIN_DETOUR(PinCushion, bool, OnPinOutput, ZEntityRef entity, uint32 pinId, const ZObjectRef& data);
 	//DECLARE_PLUGIN_DETOUR(PinCushion, bool, OnPinInput, ZEntityRef entity, uint32 pinId, const ZObjectRef& data);
 
-	auto getRecentPinIterator(uint32 pinId) -> std::list<PinData>::iterator {
-		for (auto it = pinData.begin(); it != pinData.end(); ++it)
-			if (it->id == pinId) return it;
-		return pinData.end();
-	}
-
-	auto getUpdateDataAction() const -> UpdateDataAction {
-		return updateDataAction;
-	}
-
+	// UI only. True while the UI has an action it hasn't handed over yet, during which no other can be chosen.
 	auto haveUpdateDataAction() const -> bool {
-		return updateDataAction != UpdateDataAction::None;
+		return uiRequest.action != UpdateDataAction::None;
 	}
 
 private:
-	std::set<ZHMPin> pinBlacklist;
-	std::set<std::pair<ZHMPin, std::string>> pinCallEntityIDBlacklist;
-	std::set<std::pair<ZHMPin, std::string>> pinCallEntityNameBlacklist;
-	std::list<PinData> pinData;
-	std::vector<PinData> frozenPinData;
-	std::vector<PinData> displayPinData;
+	// Actions and the recording state are applied from OnFrameUpdate under displayDataLock. The UI holds it
+	// only to copy what it draws into a DrawState and to hand over its request.
+	PinCapture capture{ *this };
+	// Guarded by displayDataLock.
+	std::shared_ptr<const PinSnapshot> frozenSnapshot;
+	// JSON export being written to disk, waited for on unload.
+	std::future<void> exportTask;
+	uint32 appliedFilterVersion = 0;
 	//std::shared_mutex pinDataLock;
-	std::chrono::system_clock::time_point lastCleanupTime;
 	std::chrono::system_clock::time_point lastDisplayUpdateTime;
 	std::shared_mutex displayDataLock;
-	std::shared_mutex filterInputLock;
-	std::shared_mutex filterEntityInputLock;
+	// Filters and the trigger are compiled on the game thread from text handed over by the UI under filterInputLock.
+	std::mutex filterInputLock;
+	std::string filterNameText;
+	std::string filterEntityText;
+	std::string triggerText;
+	// Why the trigger didn't compile, handed back to the UI under filterInputLock.
+	std::string triggerError;
+	std::atomic<uint32> filterInputVersion = 0;
+	std::atomic<bool> filterInvalid = false;
 	double lastLogTime = 0;
-	double lastFreqPruneTime = 0;
-	UpdateDataAction updateDataAction = UpdateDataAction::None;
-	ZHMPin blacklistPin = static_cast<ZHMPin>(0);
-	std::string blacklistEntityID = "";
-	std::string blacklistEntityTypeName = "";
-	uint64 rateLimit = 15;
-	int uiRateLimit = 15;
-	bool enableRateBlock = true;
+	// Hook rates shown in the Perf tab, sampled about once a second.
+	std::chrono::steady_clock::time_point perfRateTime;
+	uint64 perfRateHookCount = 0;
+	uint64 perfRateQueuedCount = 0;
+	double hookCallsPerSecond = 0;
+	double queuedCallsPerSecond = 0;
+	// Edited by the UI while drawing and handed over as pendingRequest once OnFrameUpdate took the last one.
+	UpdateDataRequest uiRequest;
+	// Guarded by displayDataLock.
+	UpdateDataRequest pendingRequest;
+	std::atomic<bool> requestPending = false;
+	// Left pane sorting and filtering, only used by the UI.
+	int uiPinSortOrder = static_cast<int>(PinSortOrder::Recent);
+	float minPinRate = 0;
 	bool hooksInstalled = false;
 	bool m_ShowMessage = false;
 	char filterInput[40] = "";
 	char filterEntityInput[40] = "";
-	std::string_view filterInputSV;
-	std::string_view filterEntityInputSV;
+	char triggerInput[256] = "";
 };
 
 DEFINE_ZHM_PLUGIN(PinCushion)
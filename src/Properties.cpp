@@ -1,53 +1,122 @@
 #include "Properties.h"
 #include "Functions.h"
+#include "JsonWriter.h"
+#include <algorithm>
+#include <charconv>
 #include <format>
-#include <imgui.h>
 #include <string>
+#include <type_traits>
 
 using namespace std::string_literals;
+using namespace std::string_view_literals;
 
-static auto ZDynamicObjectToString(ZDynamicObject& obj) -> std::string {
-	// Handle the main object structure so we can invoke ourselves for individual entries.
-	if (obj.Is<TArray<SDynamicObjectKeyValuePair>>()) {
-		auto arr = obj.As<TArray<SDynamicObjectKeyValuePair>>();
-		auto first = true;
-		auto str = std::ostringstream();
-		str << "{";
+// Writes pieces of a formatted value into a PropertyInfo::FormatBuffer.
+struct FormatCursor {
+	char* begin;
+	char* pos;
+	char* end;
+
+	auto Text(std::string_view text) -> FormatCursor& {
+		pos = std::copy_n(text.data(), std::min<size_t>(text.size(), end - pos), pos);
+		return *this;
+	}
 
-		for (auto& entry : *arr) {
-			if (!first) str << ",";
-			first = false;
+	template <typename T>
+	auto Number(T value) -> FormatCursor& {
+		pos = std::to_chars(pos, end, value).ptr;
+		return *this;
+	}
 
-			auto objStr = ZDynamicObjectToString(entry.value);
+	auto View() const -> std::string_view {
+		return { begin, static_cast<size_t>(pos - begin) };
+	}
+};
+
+std::string_view PropertyInfo::Format(FormatBuffer& buffer) const {
+    FormatCursor out{ buffer.data(), buffer.data(), buffer.data() + buffer.size() };
+
+    return std::visit([&](const auto& s_Value) -> std::string_view {
+        using T = std::decay_t<decltype(s_Value)>;
+
+        if constexpr (std::is_same_v<T, std::monostate>)
+            return "<error>"sv;
+        else if constexpr (std::is_same_v<T, std::string>)
+            return s_Value;
+        else if constexpr (std::is_same_v<T, PropertyInfo_Json>)
+            return s_Value.value;
+        else if constexpr (std::is_same_v<T, bool>)
+            return s_Value ? "true"sv : "false"sv;
+        else if constexpr (std::is_arithmetic_v<T>)
+            out.Number(s_Value);
+        else if constexpr (std::is_same_v<T, PropertyInfo_EnumValue>) {
+            if (const auto s_Name = s_Value.Name())
+                return s_Name;
+            out.Number(s_Value.value);
+        }
+        else if constexpr (std::is_same_v<T, SVector2>)
+            out.Number(s_Value.x).Text(", ").Number(s_Value.y);
+        else if constexpr (std::is_same_v<T, SVector3>)
+            out.Number(s_Value.x).Text(", ").Number(s_Value.y).Text(", ").Number(s_Value.z);
+        else if constexpr (std::is_same_v<T, SVector4>)
+            out.Number(s_Value.x).Text(", ").Number(s_Value.y).Text(", ").Number(s_Value.z).Text(", ").Number(s_Value.w);
+        else if constexpr (std::is_same_v<T, SColorRGB>)
+            out.Text("RGB: ").Number(s_Value.r).Text(", ").Number(s_Value.g).Text(", ").Number(s_Value.b);
+        else if constexpr (std::is_same_v<T, SColorRGBA>)
+            out.Text("RGBA: ").Number(s_Value.r).Text(", ").Number(s_Value.g).Text(", ").Number(s_Value.b).Text(", ").Number(s_Value.a);
+        else if constexpr (std::is_same_v<T, SMatrix43>)
+            out.Text("x: ").Number(s_Value.XAxis.x).Text(", y: ").Number(s_Value.YAxis.x).Text(", z: ").Number(s_Value.ZAxis.x).Text(", t: ").Number(s_Value.Trans.x);
+
+        return out.View();
+    }, value);
+}
+
+static auto WriteDynamicObject(JsonWriter& writer, ZDynamicObject& obj) -> void {
+	// Nothing more is written, so don't walk the rest of the object or call into the game for it.
+	if (writer.Skipping()) {
+		writer.Null();
+		return;
+	}
 
-			// Key should never contain quotes but we'll do quoted to be on the safe side + it's neater.
-			str << std::quoted(entry.sKey.c_str()) << ":" << objStr.c_str();
+	// Handle the main object structure so we can invoke ourselves for individual entries.
+	if (obj.Is<TArray<SDynamicObjectKeyValuePair>>()) {
+		writer.BeginObject();
+
+		for (auto& entry : *obj.As<TArray<SDynamicObjectKeyValuePair>>()) {
+			if (writer.Skipping()) break;
+			writer.Key(entry.sKey.ToStringView());
+			WriteDynamicObject(writer, entry.value);
 		}
 
-		str << "}";
-		return str.str();
+		writer.EndObject();
+		return;
 	}
 
 	if (obj.Is<ZString>()) {
-		// Remove null terminator from strings.
+		// Strings may include their null terminator.
 		auto res = obj.As<ZString>();
 		auto resSV = std::string_view(res->c_str(), res->size());
-		auto fixedStr = std::string(resSV.size(), '\0');
-		std::remove_copy(resSV.cbegin(), resSV.cend(), fixedStr.begin(), '\n');
-
-		// Quote the string.
-		return (std::ostringstream() << std::quoted(fixedStr.c_str())).str();
+		writer.String(resSV.substr(0, resSV.find('\0')));
+		return;
 	}
 
 	if (obj.Is<SVector3>()) {
 		auto res = obj.As<SVector3>();
-		return (std::ostringstream() << std::quoted(std::to_string(res->x) + "," + std::to_string(res->y) + "," + std::to_string(res->z))).str();
+		char chars[64];
+		auto end = chars;
+
+		for (auto component : { res->x, res->y, res->z }) {
+			if (end != chars) *end++ = ',';
+			end = std::to_chars(end, chars + sizeof(chars), component).ptr;
+		}
+
+		writer.String(std::string_view(chars, end));
+		return;
 	}
 
 	// Use the game method for anything we don't need to handle.
 	ZString res;
 	Functions::ZDynamicObject_ToString->Call(const_cast<ZDynamicObject*>(&obj), &res);
-	return std::string{res.ToStringView()};
+	writer.Raw(res.ToStringView());
 }
 
 PropertyInfo Properties::UnsupportedProperty(STypeID* p_Type, void* p_Data) {
@@ -62,57 +131,57 @@ PropertyInfo Properties::StringProperty(STypeID* p_Type, void* p_Data) {
 
 PropertyInfo Properties::BoolProperty(STypeID* p_Type, void* p_Data) {
     auto s_Value = *static_cast<bool*>(p_Data);
-    return PropertyInfo{s_Value ? "true" : "false"};
+    return PropertyInfo(s_Value);
 }
 
 PropertyInfo Properties::Uint8Property(STypeID* p_Type, void* p_Data) {
     auto s_Value = *static_cast<uint8*>(p_Data);
-    return std::format("{}", s_Value);
+    return PropertyInfo(static_cast<uint64>(s_Value));
 }
 
 PropertyInfo Properties::Uint16Property(STypeID* p_Type, void* p_Data) {
     auto s_Value = *static_cast<uint16*>(p_Data);
-    return std::format("{}", s_Value);
+    return PropertyInfo(static_cast<uint64>(s_Value));
 }
 
 PropertyInfo Properties::Uint32Property(STypeID* p_Type, void* p_Data) {
     auto s_Value = *static_cast<uint32*>(p_Data);
-    return std::format("{}", s_Value);
+    return PropertyInfo(static_cast<uint64>(s_Value));
 }
 
 PropertyInfo Properties::Uint64Property(STypeID* p_Type, void* p_Data) {
     auto s_Value = *static_cast<uint64*>(p_Data);
-    return std::format("{}", s_Value);
+    return PropertyInfo(static_cast<uint64>(s_Value));
 }
 
 PropertyInfo Properties::Int8Property(STypeID* p_Type, void* p_Data) {
     auto s_Value = *static_cast<int8*>(p_Data);
-    return std::format("{}", s_Value);
+    return PropertyInfo(static_cast<int64>(s_Value));
 }
 
 PropertyInfo Properties::Int16Property(STypeID* p_Type, void* p_Data) {
     auto s_Value = *static_cast<int16*>(p_Data);
-    return std::format("{}", s_Value);
+    return PropertyInfo(static_cast<int64>(s_Value));
 }
 
 PropertyInfo Properties::Int32Property(STypeID* p_Type, void* p_Data) {
     auto s_Value = *static_cast<int32*>(p_Data);
-    return std::format("{}", s_Value);
+    return PropertyInfo(static_cast<int64>(s_Value));
 }
 
 PropertyInfo Properties::Int64Property(STypeID* p_Type, void* p_Data) {
     auto s_Value = *static_cast<int64*>(p_Data);
-    return std::format("{}", s_Value);
+    return PropertyInfo(static_cast<int64>(s_Value));
 }
 
 PropertyInfo Properties::Float32Property(STypeID* p_Type, void* p_Data) {
     auto s_Value = *static_cast<float32*>(p_Data);
-    return std::format("{}", s_Value);
+    return PropertyInfo(s_Value);
 }
 
 PropertyInfo Properties::Float64Property(STypeID* p_Type, void* p_Data) {
     auto s_Value = *static_cast<float64*>(p_Data);
-    return std::format("{}", s_Value);
+    return PropertyInfo(s_Value);
 }
 
 PropertyInfo Properties::SColorRGBProperty(STypeID* p_Type, void* p_Data) {
@@ -158,5 +227,11 @@ PropertyInfo Properties::ZRepositoryIDProperty(STypeID* p_Type, ZRepositoryID* p
 }
 
 PropertyInfo Properties::ZDynamicObjectProperty(STypeID* p_Type, ZDynamicObject* p_Data) {
-    return p_Data ? ZDynamicObjectToString(*p_Data) : "null"s;
+    if (!p_Data) return PropertyInfo::Json("null"s);
+
+    // Reused so serializing only allocates the resulting string.
+    thread_local JsonWriter s_Writer;
+    s_Writer.Clear();
+    WriteDynamicObject(s_Writer, *p_Data);
+    return PropertyInfo::Json(std::string(s_Writer.View()));
 }
\ No newline at end of file
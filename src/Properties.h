@@ -1,4 +1,5 @@
 #pragma once
+#include "StringInterner.h"
 #include <Glacier/IEnumType.h>
 #include <Glacier/SColorRGB.h>
 #include <Glacier/SColorRGBA.h>
@@ -6,8 +7,10 @@
 #include <Glacier/ZMath.h>
 #include <Glacier/ZObject.h>
 #include <Glacier/ZResource.h>
+#include <array>
 #include <string>
-#include <optional>
+#include <string_view>
+#include <variant>
 
 struct PropertyInfo_EnumValue {
     int32 value;
@@ -15,82 +18,116 @@ struct PropertyInfo_EnumValue {
 
     PropertyInfo_EnumValue(IEnumType* type, int32 value) : type(type), value(value)
     { }
+
+    // Name of the value, or nullptr if the enum doesn't list it.
+    const char* Name() const {
+        for (auto& s_EnumValue : type->m_entries) {
+            if (s_EnumValue.m_nValue == value)
+                return s_EnumValue.m_pName;
+        }
+        return nullptr;
+    }
+};
+
+// Text that is already a JSON document.
+struct PropertyInfo_Json {
+    std::string value;
 };
 
 class PropertyInfo {
 public:
-    std::string name;
-    std::string typeName;
-    std::string inputId;
-    std::optional<std::string> primitiveValue;
-    std::optional<SColorRGB> rgb;
-    std::optional<SColorRGBA> rgba;
-    std::optional<PropertyInfo_EnumValue> enumValue;
-    std::optional<SMatrix43> matrixValue;
-    std::optional<SVector2> vec2Value;
-    std::optional<SVector3> vec3Value;
-    std::optional<SVector4> vec4Value;
-    std::optional<std::string> str;
+    // Text gets std::string's small string optimization, everything else is stored as decoded and only
+    // formatted when displayed, so a property is only as large as its largest value (the matrix).
+    using Value = std::variant<
+        std::monostate,
+        std::string,
+        PropertyInfo_Json,
+        bool,
+        int64,
+        uint64,
+        float32,
+        float64,
+        PropertyInfo_EnumValue,
+        SVector2,
+        SVector3,
+        SVector4,
+        SColorRGB,
+        SColorRGBA,
+        SMatrix43
+    >;
+
+    // Enough for any value Format() writes, the longest being a matrix or color of four floats.
+    using FormatBuffer = std::array<char, 128>;
+
+    Symbol name = 0;
+    Symbol typeName = 0;
+    Symbol inputId = 0;
     bool hasNoDirectName = false;
+    // Set when the value differs from the entity's previous captured call.
+    bool changed = false;
+    Value value;
 
     PropertyInfo() = default;
 
-    PropertyInfo(const SColorRGB& value) : rgb(value)
+    PropertyInfo(std::string&& value) : value(std::move(value))
     { }
 
-    PropertyInfo(const SColorRGBA& value) : rgba(value)
+    PropertyInfo(PropertyInfo_Json&& value) : value(std::move(value))
     { }
 
-    PropertyInfo(std::string&& value) : primitiveValue(value)
+    PropertyInfo(const PropertyInfo_EnumValue& value) : value(value)
     { }
 
-    PropertyInfo(const PropertyInfo_EnumValue& value) : enumValue(value)
+    PropertyInfo(const SColorRGB& value) : value(value)
     { }
 
-    PropertyInfo(const SMatrix43& value) : matrixValue(value)
+    PropertyInfo(const SColorRGBA& value) : value(value)
     { }
 
-    PropertyInfo(const SVector2& value) : vec2Value(value)
+    PropertyInfo(const SMatrix43& value) : value(value)
     { }
 
-    PropertyInfo(const SVector3& value) : vec3Value(value)
+    PropertyInfo(const SVector2& value) : value(value)
     { }
 
-    PropertyInfo(const SVector4& value) : vec4Value(value)
+    PropertyInfo(const SVector3& value) : value(value)
     { }
 
-    const std::string& ToString() {
-        if (!str.has_value()) {
-            str = "<error>";
-            if (this->primitiveValue)
-                str = this->primitiveValue;
-            else if (this->vec2Value)
-                str = std::format("{}, {}", this->vec2Value->x, this->vec2Value->y);
-            else if (this->vec3Value)
-                str = std::format("{}, {}, {}", this->vec3Value->x, this->vec3Value->y, this->vec3Value->z);
-            else if (this->vec4Value)
-                str = std::format("{}, {}, {}, {}", this->vec4Value->x, this->vec4Value->y, this->vec4Value->z, this->vec4Value->w);
-            else if (this->rgb)
-                str = std::format("RGB: {}, {}, {}", this->rgb->r, this->rgb->g, this->rgb->b);
-            else if (this->rgba)
-                str = std::format("RGBA: {}, {}, {}", this->rgba->r, this->rgba->g, this->rgba->b, this->rgba->a);
-            else if (this->enumValue) {
-                auto& enumVal = *this->enumValue;
-                str = "";
-
-                for (auto& s_EnumValue : enumVal.type->m_entries) {
-                    if (s_EnumValue.m_nValue != enumVal.value) continue;
-                    str = s_EnumValue.m_pName;
-                }
-
-                if (str->empty()) str = std::to_string(enumVal.value);
-            }
-            else if (this->matrixValue) {
-                str = std::format("x: {}, y: {}, z: {}, t: {}", this->matrixValue->XAxis.x, this->matrixValue->YAxis.x, this->matrixValue->ZAxis.x, this->matrixValue->Trans.x);
-            }
-        }
-        return *str;
+    PropertyInfo(const SVector4& value) : value(value)
+    { }
+
+    // Explicit so string literals and pointers don't silently become bools or numbers.
+    explicit PropertyInfo(bool value) : value(value)
+    { }
+
+    explicit PropertyInfo(int64 value) : value(value)
+    { }
+
+    explicit PropertyInfo(uint64 value) : value(value)
+    { }
+
+    explicit PropertyInfo(float32 value) : value(value)
+    { }
+
+    explicit PropertyInfo(float64 value) : value(value)
+    { }
+
+    static PropertyInfo Json(std::string&& value) {
+        return PropertyInfo(PropertyInfo_Json{ std::move(value) });
     }
+
+    template <typename T>
+    T* Get() {
+        return std::get_if<T>(&value);
+    }
+
+    template <typename T>
+    const T* Get() const {
+        return std::get_if<T>(&value);
+    }
+
+    // Formats the value for display. Text is returned as stored, anything else is written into `buffer`.
+    std::string_view Format(FormatBuffer& buffer) const;
 };
 
 class Properties {
@@ -0,0 +1,117 @@
+#include "PropertyDecoders.h"
+#include "FlatHashMap.h"
+#include <array>
+#include <mutex>
+#include <shared_mutex>
+#include <string_view>
+
+using namespace std::string_view_literals;
+
+struct BuiltinDecoder {
+	std::string_view typeName;
+	PropertyDecodeFn decode;
+	bool trivial = false;
+	PropertyMeasureFn measure = nullptr;
+	PropertyEqualFn equal = nullptr;
+};
+
+// Copies are counted as owning their characters, although the game may share them between strings.
+static auto StringBytes(STypeID*, const void* p_Data) -> OwnedBytes {
+	return { static_cast<const ZString*>(p_Data)->size() + size_t(1) };
+}
+
+static auto StringEqual(const void* p_A, const void* p_B) -> bool {
+	return static_cast<const ZString*>(p_A)->ToStringView() == static_cast<const ZString*>(p_B)->ToStringView();
+}
+
+// The value lives in its own allocation, and objects hold their entries in an array of key value pairs.
+// Values of any other type that isn't plain data can't be measured.
+static auto DynamicObjectBytes(STypeID*, const void* p_Data) -> OwnedBytes {
+	const auto& s_Object = *static_cast<const ZDynamicObject*>(p_Data);
+	const auto s_Type = s_Object.GetTypeID();
+	const auto s_TypeInfo = s_Type ? s_Type->typeInfo() : nullptr;
+	if (!s_TypeInfo) return {};
+
+	OwnedBytes owned{ s_TypeInfo->m_nTypeSize };
+
+	if (s_Object.Is<TArray<SDynamicObjectKeyValuePair>>()) {
+		const auto& s_Entries = *s_Object.As<TArray<SDynamicObjectKeyValuePair>>();
+		owned.bytes += (s_Entries.m_pAllocationEnd - s_Entries.m_pBegin) * sizeof(SDynamicObjectKeyValuePair);
+
+		for (const auto& entry : s_Entries) {
+			owned += StringBytes(nullptr, &entry.sKey);
+			owned += DynamicObjectBytes(nullptr, &entry.value);
+		}
+	}
+	else if (s_Object.Is<ZString>())
+		owned += StringBytes(nullptr, s_Object.As<ZString>());
+	else if (!PropertyDecoders::Resolve(s_Type).trivial)
+		owned.measured = false;
+
+	return owned;
+}
+
+// Resource pointers only hold a reference to a resource the game owns.
+static auto ResourceBytes(STypeID*, const void*) -> OwnedBytes {
+	return {};
+}
+
+static constexpr auto s_BuiltinDecoders = std::to_array<BuiltinDecoder>({
+	{ "ZString"sv, &Properties::StringProperty, false, &StringBytes, &StringEqual },
+	{ "bool"sv, &Properties::BoolProperty, true },
+	{ "uint8"sv, &Properties::Uint8Property, true },
+	{ "int8"sv, &Properties::Int8Property, true },
+	{ "uint16"sv, &Properties::Uint16Property, true },
+	{ "int16"sv, &Properties::Int16Property, true },
+	{ "uint32"sv, &Properties::Uint32Property, true },
+	{ "int32"sv, &Properties::Int32Property, true },
+	{ "uint64"sv, &Properties::Uint64Property, true },
+	{ "int64"sv, &Properties::Int64Property, true },
+	{ "float32"sv, &Properties::Float32Property, true },
+	{ "float64"sv, &Properties::Float64Property, true },
+	{ "SVector2"sv, &Properties::SVector2Property, true },
+	{ "SVector3"sv, &Properties::SVector3Property, true },
+	{ "SVector4"sv, &Properties::SVector4Property, true },
+	{ "SMatrix43"sv, &Properties::SMatrix43Property, true },
+	{ "SColorRGB"sv, &Properties::SColorRGBProperty, true },
+	{ "SColorRGBA"sv, &Properties::SColorRGBAProperty, true },
+	{ "ZRepositoryID"sv, [](STypeID* p_Type, void* p_Data) { return Properties::ZRepositoryIDProperty(p_Type, static_cast<ZRepositoryID*>(p_Data)); }, true },
+	{ "ZDynamicObject"sv, [](STypeID* p_Type, void* p_Data) { return Properties::ZDynamicObjectProperty(p_Type, static_cast<ZDynamicObject*>(p_Data)); }, false, &DynamicObjectBytes },
+	//{ "TEntityRef<"sv, &Properties::TEntityRefProperty },
+});
+
+static auto ResolveUncached(STypeID* p_Type) -> PropertyDecoder {
+	const auto s_TypeInfo = p_Type ? p_Type->typeInfo() : nullptr;
+	if (!s_TypeInfo) return {};
+
+	const std::string_view s_TypeName = s_TypeInfo->m_pTypeName;
+
+	for (const auto& builtin : s_BuiltinDecoders) {
+		if (builtin.typeName == s_TypeName)
+			return { builtin.decode, true, builtin.trivial, builtin.measure, builtin.equal };
+	}
+
+	if (s_TypeInfo->isEnum())
+		return { &Properties::EnumProperty, true, true };
+	if (s_TypeInfo->isResource())
+		return { &Properties::ResourceProperty, true, false, &ResourceBytes };
+
+	return {};
+}
+
+// Decoding happens on both the game thread (payloads) and the UI thread (properties), hence the lock.
+static std::shared_mutex s_DecoderCacheLock;
+static FlatHashMap<STypeID*, PropertyDecoder> s_DecoderCache(256);
+
+auto PropertyDecoders::Resolve(STypeID* p_Type) -> PropertyDecoder {
+	{
+		auto lock = std::shared_lock(s_DecoderCacheLock);
+		if (auto decoder = s_DecoderCache.Find(p_Type))
+			return *decoder;
+	}
+
+	const auto decoder = ResolveUncached(p_Type);
+	auto lock = std::unique_lock(s_DecoderCacheLock);
+	s_DecoderCache.Insert(p_Type, decoder);
+	return decoder;
+}
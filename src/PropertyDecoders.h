@@ -0,0 +1,30 @@
+#pragma once
+#include "MemoryUsage.h"
+#include "Properties.h"
+
+using PropertyDecodeFn = PropertyInfo (*)(STypeID* p_Type, void* p_Data);
+using PropertyMeasureFn = OwnedBytes (*)(STypeID* p_Type, const void* p_Data);
+using PropertyEqualFn = bool (*)(const void* p_A, const void* p_B);
+
+struct PropertyDecoder {
+	PropertyDecodeFn decode = &Properties::UnsupportedProperty;
+	// False when the type fell through to UnsupportedProperty.
+	bool supported = false;
+	// Plain data that can be copied with memcpy and has nothing to destruct.
+	bool trivial = false;
+	// Heap bytes a copy of a value owns. Null for plain data and for types whose memory can't be measured.
+	PropertyMeasureFn measure = nullptr;
+	// Compares two values of a type that isn't plain data, null if they can't be compared.
+	PropertyEqualFn equal = nullptr;
+};
+
+// Maps property types to their Properties decoder.
+// Each STypeID is resolved by name once and then served from a pointer-keyed cache.
+class PropertyDecoders {
+public:
+	static auto Resolve(STypeID* p_Type) -> PropertyDecoder;
+
+	static auto Decode(STypeID* p_Type, void* p_Data) -> PropertyInfo {
+		return Resolve(p_Type).decode(p_Type, p_Data);
+	}
+};
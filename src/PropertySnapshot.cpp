@@ -0,0 +1,342 @@
+#include "PropertySnapshot.h"
+#include "MemoryUsage.h"
+#include "SlabArena.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <string>
+
+static auto AlignUp(size_t offset, size_t alignment) -> size_t {
+	return (offset + alignment - 1) & ~(alignment - 1);
+}
+
+// Copies and compares plain data values, with the common sizes spelled out so they compile down to a few
+// instructions.
+static auto CopyPlain(void* dest, const void* src, size_t size) -> void {
+	switch (size) {
+	case 1: std::memcpy(dest, src, 1); break;
+	case 4: std::memcpy(dest, src, 4); break;
+	case 8: std::memcpy(dest, src, 8); break;
+	case 12: std::memcpy(dest, src, 12); break;
+	case 16: std::memcpy(dest, src, 16); break;
+	default: std::memcpy(dest, src, size); break;
+	}
+}
+
+static auto EqualPlain(const void* a, const void* b, size_t size) -> bool {
+	switch (size) {
+	case 1: return std::memcmp(a, b, 1) == 0;
+	case 4: return std::memcmp(a, b, 4) == 0;
+	case 8: return std::memcmp(a, b, 8) == 0;
+	case 12: return std::memcmp(a, b, 12) == 0;
+	case 16: return std::memcmp(a, b, 16) == 0;
+	default: return std::memcmp(a, b, size) == 0;
+	}
+}
+
+static std::atomic<size_t> s_KeyframeBytes = 0;
+static std::atomic<size_t> s_MaterializedBytes = 0;
+static std::atomic<size_t> s_UnmeasuredValues = 0;
+
+PropertySnapshot::~PropertySnapshot() {
+	if (keyframeBytes)
+		s_KeyframeBytes.fetch_sub(keyframeBytes, std::memory_order_relaxed);
+	if (resolvedBytes)
+		s_MaterializedBytes.fetch_sub(resolvedBytes, std::memory_order_relaxed);
+	if (unmeasuredValues)
+		s_UnmeasuredValues.fetch_sub(unmeasuredValues, std::memory_order_relaxed);
+
+	if (!storage) return;
+
+	if (!layout->trivial) {
+		this->ForEachStored([](size_t, const PropertyLayout& prop, std::byte* data) {
+			if (!prop.decoder.trivial)
+				prop.type->typeInfo()->m_pTypeFunctions->destruct(data);
+		});
+	}
+
+	SlabArena::Global().Free(storage, this->BlockBytes(), layout->storageAlignment);
+}
+
+auto PropertySnapshot::IsStored(size_t index) const -> bool {
+	if (!base) return true;
+
+	const auto& prop = layout->properties[index];
+	if (!prop.compared) return prop.decoder.supported;
+
+	return (static_cast<uint8>(storage[valueBytes + this->BitsetBytes() + index / 8]) >> (index % 8)) & 1;
+}
+
+auto PropertySnapshot::BlockBytes() const -> size_t {
+	return valueBytes + this->BitsetBytes() * (base ? 2 : 1);
+}
+
+// Keyframes keep values at their layout offsets, deltas pack the ones they store in property order.
+template <typename Fn>
+auto PropertySnapshot::ForEachStored(Fn&& fn) const -> void {
+	const auto& s_Props = layout->properties;
+
+	if (!base) {
+		for (size_t i = 0; i < s_Props.size(); ++i)
+			fn(i, s_Props[i], storage + s_Props[i].storageOffset);
+		return;
+	}
+
+	size_t offset = 0;
+
+	for (size_t i = 0; i < s_Props.size(); ++i) {
+		if (!this->IsStored(i)) continue;
+
+		offset = AlignUp(offset, s_Props[i].alignment);
+		fn(i, s_Props[i], storage + offset);
+		offset += s_Props[i].size;
+	}
+}
+
+auto PropertySnapshot::ValueInOrder(size_t index, size_t& offset) const -> const std::byte* {
+	const auto& prop = layout->properties[index];
+
+	if (!base)
+		return storage + prop.storageOffset;
+	if (!this->IsStored(index))
+		return base->storage + prop.storageOffset;
+
+	offset = AlignUp(offset, prop.alignment);
+	const auto* s_Value = storage + offset;
+	offset += prop.size;
+	return s_Value;
+}
+
+// Copies a value out of the entity into snapshot storage.
+static auto CopyValue(const PropertyLayout& prop, void* source, std::byte* data) -> void {
+	// Plain data is copied straight out of the entity instead of through the type's copy constructor.
+	if (prop.useGetter)
+		prop.info->get(source, data, prop.info->m_nOffset);
+	else if (prop.decoder.trivial)
+		CopyPlain(data, source, prop.size);
+	else
+		prop.type->typeInfo()->m_pTypeFunctions->copyConstruct(data, source);
+}
+
+static auto SetBit(std::byte* bits, size_t index) -> void {
+	bits[index / 8] |= std::byte(1 << (index % 8));
+}
+
+// Whether a value differs from the previous capture's, for values the decoder can compare.
+static auto ValueChanged(const PropertyLayout& prop, const void* value, const void* previous) -> bool {
+	if (prop.compared)
+		return !EqualPlain(value, previous, prop.size);
+	return prop.decoder.equal && !prop.decoder.equal(value, previous);
+}
+
+auto PropertySnapshot::Capture(ZEntityRef entity, std::shared_ptr<const EntityLayout> layout, PropertyHistory* history) -> std::shared_ptr<PropertySnapshot> {
+	auto snapshot = std::allocate_shared<PropertySnapshot>(SlabAllocator<PropertySnapshot>());
+	snapshot->layout = std::move(layout);
+
+	const auto& s_Layout = *snapshot->layout;
+	const auto& s_Props = s_Layout.properties;
+
+	if (s_Props.empty()) {
+		snapshot->CountKeyframe();
+		return snapshot;
+	}
+
+	// A history left by a capture with a different layout has nothing to compare against.
+	if (history && history->layout != &s_Layout) {
+		history->last.reset();
+		history->layout = &s_Layout;
+	}
+
+	const auto s_PreviousRef = history ? history->last.lock() : nullptr;
+	const auto* s_Previous = s_PreviousRef.get();
+	const auto s_EntityAddress = reinterpret_cast<uintptr_t>(entity.m_pEntity);
+	const auto s_BitsetBytes = snapshot->BitsetBytes();
+
+	if (!s_Previous || history->sinceKeyframe >= KeyframeInterval) {
+		snapshot->valueBytes = s_Layout.storageSize;
+		snapshot->storage = static_cast<std::byte*>(SlabArena::Global().Allocate(snapshot->BlockBytes(), s_Layout.storageAlignment));
+
+		auto* s_Changed = snapshot->storage + snapshot->valueBytes;
+		std::memset(s_Changed, 0, s_BitsetBytes);
+		size_t s_PreviousOffset = 0;
+
+		for (size_t i = 0; i < s_Props.size(); ++i) {
+			const auto& prop = s_Props[i];
+			auto* s_Data = snapshot->storage + prop.storageOffset;
+
+			CopyValue(prop, reinterpret_cast<void*>(s_EntityAddress + prop.entityOffset), s_Data);
+
+			if (!s_Previous) continue;
+
+			const auto* s_PreviousValue = s_Previous->ValueInOrder(i, s_PreviousOffset);
+			if (ValueChanged(prop, s_Data, s_PreviousValue))
+				SetBit(s_Changed, i);
+		}
+
+		snapshot->MeasureOwnedBytes();
+		snapshot->CountKeyframe();
+
+		if (history) {
+			history->last = snapshot;
+			history->sinceKeyframe = 1;
+		}
+
+		return snapshot;
+	}
+
+	snapshot->base = s_Previous->base ? s_Previous->base : s_PreviousRef;
+	const auto& s_Keyframe = *snapshot->base;
+
+	// Deltas are sized by what they store, so that is worked out first. Values behind a getter are read into
+	// scratch space once, everything else is compared in place. Capture only runs on the game thread.
+	thread_local std::vector<std::max_align_t> s_Scratch;
+	thread_local std::vector<std::byte> s_Bits;
+	// Previous values of properties that aren't plain data, compared once they have been copied.
+	thread_local std::vector<const std::byte*> s_PreviousValues;
+
+	if (!s_Layout.trivial)
+		s_PreviousValues.resize(std::max(s_PreviousValues.size(), s_Props.size()));
+
+	s_Bits.assign(s_BitsetBytes * 2, std::byte(0));
+	auto* s_Changed = s_Bits.data();
+	auto* s_Stored = s_Bits.data() + s_BitsetBytes;
+	std::byte* s_Current = nullptr;
+	size_t s_ValueBytes = 0;
+	size_t s_PreviousOffset = 0;
+
+	for (size_t i = 0; i < s_Props.size(); ++i) {
+		const auto& prop = s_Props[i];
+		const auto* s_KeyframeValue = s_Keyframe.storage + prop.storageOffset;
+		const auto* s_PreviousValue = s_Previous->ValueInOrder(i, s_PreviousOffset);
+		auto stored = prop.decoder.supported;
+
+		if (!prop.decoder.trivial)
+			s_PreviousValues[i] = s_PreviousValue;
+
+		if (prop.compared) {
+			const void* s_Value = reinterpret_cast<void*>(s_EntityAddress + prop.entityOffset);
+
+			if (prop.useGetter) {
+				if (!s_Current) {
+					s_Scratch.resize(std::max(s_Scratch.size(), (s_Layout.storageSize + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t)));
+					s_Current = reinterpret_cast<std::byte*>(s_Scratch.data());
+				}
+
+				prop.info->get(const_cast<void*>(s_Value), s_Current + prop.storageOffset, prop.info->m_nOffset);
+				s_Value = s_Current + prop.storageOffset;
+			}
+
+			const auto s_ValueChanged = !EqualPlain(s_Value, s_PreviousValue, prop.size);
+			if (s_ValueChanged) SetBit(s_Changed, i);
+
+			// A value that didn't change and wasn't stored by the previous capture is still the keyframe's.
+			stored = (s_ValueChanged || s_PreviousValue != s_KeyframeValue) && !EqualPlain(s_Value, s_KeyframeValue, prop.size);
+			if (stored) SetBit(s_Stored, i);
+		}
+
+		if (stored)
+			s_ValueBytes = AlignUp(s_ValueBytes, prop.alignment) + prop.size;
+	}
+
+	snapshot->valueBytes = s_ValueBytes;
+	snapshot->storage = static_cast<std::byte*>(SlabArena::Global().Allocate(snapshot->BlockBytes(), s_Layout.storageAlignment));
+	std::memcpy(snapshot->storage + s_ValueBytes, s_Bits.data(), s_BitsetBytes * 2);
+
+	snapshot->ForEachStored([&](size_t i, const PropertyLayout& prop, std::byte* data) {
+		auto* s_Source = reinterpret_cast<void*>(s_EntityAddress + prop.entityOffset);
+
+		if (prop.compared) {
+			CopyPlain(data, prop.useGetter ? s_Current + prop.storageOffset : s_Source, prop.size);
+			return;
+		}
+
+		CopyValue(prop, s_Source, data);
+
+		if (ValueChanged(prop, data, s_PreviousValues[i]))
+			SetBit(snapshot->storage + s_ValueBytes, i);
+	});
+
+	snapshot->MeasureOwnedBytes();
+	history->last = snapshot;
+	++history->sinceKeyframe;
+	return snapshot;
+}
+
+auto PropertySnapshot::MeasureOwnedBytes() -> void {
+	if (layout->trivial) return;
+
+	this->ForEachStored([this](size_t, const PropertyLayout& prop, std::byte* data) {
+		if (prop.decoder.trivial) return;
+
+		const auto s_Owned = prop.decoder.measure ? prop.decoder.measure(prop.type, data) : OwnedBytes{ 0, false };
+		ownedBytes += s_Owned.bytes;
+		unmeasuredValues += !s_Owned.measured;
+	});
+
+	if (unmeasuredValues)
+		s_UnmeasuredValues.fetch_add(unmeasuredValues, std::memory_order_relaxed);
+}
+
+auto PropertySnapshot::CountKeyframe() -> void {
+	keyframeBytes = this->MemoryUsage();
+	s_KeyframeBytes.fetch_add(keyframeBytes, std::memory_order_relaxed);
+}
+
+auto PropertySnapshot::MemoryUsage() const -> size_t {
+	return SlabSharedBytes<PropertySnapshot> + (storage ? SlabArena::BlockSize(this->BlockBytes(), layout->storageAlignment) : 0) + ownedBytes;
+}
+
+auto PropertySnapshot::KeyframeBytes() -> size_t {
+	return s_KeyframeBytes.load(std::memory_order_relaxed);
+}
+
+auto PropertySnapshot::MaterializedBytes() -> size_t {
+	return s_MaterializedBytes.load(std::memory_order_relaxed);
+}
+
+auto PropertySnapshot::UnmeasuredValues() -> size_t {
+	return s_UnmeasuredValues.load(std::memory_order_relaxed);
+}
+
+auto PropertySnapshot::Decode(std::vector<PropertyInfo>& out) const -> void {
+	out.clear();
+	if (!layout) return;
+
+	const auto& s_Props = layout->properties;
+
+	out.reserve(s_Props.size());
+	size_t offset = 0;
+
+	for (size_t i = 0; i < s_Props.size(); ++i) {
+		const auto& layoutProp = s_Props[i];
+		auto prop = layoutProp.decoder.decode(layoutProp.type, const_cast<std::byte*>(this->ValueInOrder(i, offset)));
+
+		prop.name = layoutProp.name;
+		prop.typeName = Intern(layoutProp.type->typeInfo()->m_pTypeName);
+		prop.inputId = layoutProp.inputId;
+		prop.hasNoDirectName = layoutProp.hasNoDirectName;
+		prop.changed = this->IsChanged(i);
+
+		out.push_back(std::move(prop));
+	}
+}
+
+auto PropertySnapshot::Materialize() -> std::vector<PropertyInfo>& {
+	std::call_once(materializeFlag, [this] {
+		this->Decode(resolved);
+
+		resolvedBytes = HeapBytes(resolved);
+
+		for (const auto& prop : resolved) {
+			if (const auto s_Text = prop.Get<std::string>())
+				resolvedBytes += HeapBytes(*s_Text);
+			else if (const auto s_Json = prop.Get<PropertyInfo_Json>())
+				resolvedBytes += HeapBytes(s_Json->value);
+		}
+
+		s_MaterializedBytes.fetch_add(resolvedBytes, std::memory_order_relaxed);
+		materialized.store(true, std::memory_order_release);
+	});
+
+	return resolved;
+}
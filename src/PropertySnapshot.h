@@ -0,0 +1,110 @@
+#pragma once
+#include "EntityLayoutCache.h"
+#include "Properties.h"
+#include <Glacier/ZEntity.h>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class PropertySnapshot;
+
+// The last capture of an entity, which its next capture is compared against. It is only held as long as a
+// call holds it, so evicting the entity's calls releases it and the next capture starts over with a keyframe.
+struct PropertyHistory {
+	std::weak_ptr<const PropertySnapshot> last;
+	// Layout of `last`, kept here to check it without touching the snapshot.
+	const EntityLayout* layout = nullptr;
+	uint64 entityId = 0;
+	uint32 sinceKeyframe = 0;
+};
+
+// Raw copy of an entity's property values taken at capture time, laid out as described by its EntityLayout.
+// Display strings are only produced when the snapshot is first materialized (e.g. when shown in the UI).
+// Both the snapshot and its values are allocated from the slab arena.
+//
+// Captures with a history are delta encoded: every KeyframeInterval calls on an entity a keyframe stores
+// every value, and the captures in between only store the values that differ from it, keeping the keyframe
+// alive as their base. Compared values that changed since the previous capture are flagged either way so
+// the UI can show them. Strings are flagged the same way, but as they aren't plain data they are stored in
+// every capture rather than only when they changed.
+class PropertySnapshot {
+public:
+	static constexpr uint32 KeyframeInterval = 16;
+
+	PropertySnapshot() = default;
+	PropertySnapshot(const PropertySnapshot&) = delete;
+	PropertySnapshot& operator=(const PropertySnapshot&) = delete;
+	~PropertySnapshot();
+
+	// Without a history the snapshot is a keyframe, otherwise the history is updated to the new snapshot.
+	static auto Capture(ZEntityRef entity, std::shared_ptr<const EntityLayout> layout, PropertyHistory* history = nullptr) -> std::shared_ptr<PropertySnapshot>;
+
+	// Decodes the raw values into PropertyInfos on first use, the result is kept for later calls.
+	auto Materialize() -> std::vector<PropertyInfo>&;
+	// What Materialize() decoded, or null if it hasn't been called yet.
+	auto Materialized() const -> const std::vector<PropertyInfo>* {
+		return materialized.load(std::memory_order_acquire) ? &resolved : nullptr;
+	}
+	// Decodes the raw values into `out` without keeping them, for one-off uses like exports.
+	auto Decode(std::vector<PropertyInfo>& out) const -> void;
+
+	auto Size() const -> size_t {
+		return layout ? layout->properties.size() : 0;
+	}
+
+	auto IsKeyframe() const -> bool {
+		return !base;
+	}
+
+	// Bytes held by this snapshot, its raw values and the heap memory they own as far as it can be measured.
+	// The shared layout, the keyframe it is based on and anything decoded by Materialize() aren't included.
+	auto MemoryUsage() const -> size_t;
+
+	// MemoryUsage() of all live keyframes. As the deltas based on a keyframe keep it alive after the call it
+	// was captured for is gone, they are counted here rather than by any one call.
+	static auto KeyframeBytes() -> size_t;
+	// Bytes decoded by Materialize() across all live snapshots.
+	static auto MaterializedBytes() -> size_t;
+	// Values stored by live snapshots whose heap memory can't be measured, so only their own size is counted.
+	static auto UnmeasuredValues() -> size_t;
+
+private:
+	auto BitsetBytes() const -> size_t {
+		return (layout->properties.size() + 7) / 8;
+	}
+
+	auto IsChanged(size_t index) const -> bool {
+		return (static_cast<uint8>(storage[valueBytes + index / 8]) >> (index % 8)) & 1;
+	}
+
+	auto IsStored(size_t index) const -> bool;
+	auto BlockBytes() const -> size_t;
+	// Sums up the heap memory owned by the stored values that aren't plain data.
+	auto MeasureOwnedBytes() -> void;
+	auto CountKeyframe() -> void;
+	// Raw value of a property, for each property in order. `offset` starts at zero and tracks the position
+	// in a delta's stored values.
+	auto ValueInOrder(size_t index, size_t& offset) const -> const std::byte*;
+
+	// Calls `fn(index, prop, data)` for every value this snapshot stores.
+	template <typename Fn>
+	auto ForEachStored(Fn&& fn) const -> void;
+
+	std::shared_ptr<const EntityLayout> layout;
+	// Keyframe that values not stored here are taken from, null for keyframes.
+	std::shared_ptr<const PropertySnapshot> base;
+	// The stored values followed by a bit per property that is set when it changed, and for deltas another
+	// bit per compared property that is set when it is stored.
+	std::byte* storage = nullptr;
+	size_t valueBytes = 0;
+	size_t ownedBytes = 0;
+	// What was added to KeyframeBytes() for this snapshot.
+	size_t keyframeBytes = 0;
+	uint32 unmeasuredValues = 0;
+	std::once_flag materializeFlag;
+	std::atomic<bool> materialized = false;
+	std::vector<PropertyInfo> resolved;
+	size_t resolvedBytes = 0;
+};
@@ -0,0 +1,104 @@
+#pragma once
+#include "FlatHashMap.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Per-(pin, entity type) token bucket checked directly in the hook.
+// Each key may fire `rate` times per second on average with bursts of up to `burst` events. Events over
+// the limit are dropped, or when sampling is enabled one in every `sampleEvery` of them is still let through.
+class RateLimiter {
+public:
+	using Clock = std::chrono::steady_clock;
+	using Key = std::pair<uint32_t, const void*>;
+
+	struct Bucket {
+		Clock::time_point lastRefill;
+		float tokens = 0;
+		uint32_t overLimit = 0;
+	};
+
+	auto Allow(uint32_t pinId, const void* entityType, Clock::time_point now) -> bool {
+		auto [bucket, inserted] = buckets.TryEmplace(Key(pinId, entityType));
+
+		if (inserted) {
+			bucket->tokens = burst;
+			bucket->lastRefill = now;
+		}
+		else {
+			const auto elapsed = std::chrono::duration<float>(now - bucket->lastRefill).count();
+			bucket->tokens = std::min(burst, bucket->tokens + elapsed * rate);
+			bucket->lastRefill = now;
+		}
+
+		if (bucket->tokens >= 1.f) {
+			bucket->tokens -= 1.f;
+			return true;
+		}
+
+		Increment(limited);
+
+		if (sampleEvery > 0 && ++bucket->overLimit >= sampleEvery) {
+			bucket->overLimit = 0;
+			Increment(sampled);
+			return true;
+		}
+
+		return false;
+	}
+
+	// Drops buckets that have been idle long enough to be full again, which keeps the table bounded
+	// by the number of keys active in the last few seconds.
+	auto Prune(Clock::time_point now) -> void {
+		const auto refillTime = std::chrono::duration<float>(burst / rate);
+		std::vector<Key> idle;
+
+		buckets.ForEach([&](const Key& key, const Bucket& bucket) {
+			if (now - bucket.lastRefill >= refillTime)
+				idle.push_back(key);
+		});
+
+		for (auto& key : idle)
+			buckets.Erase(key);
+	}
+
+	auto Configure(float perSecond, float burstSeconds, uint32_t sampleOneIn) -> void {
+		rate = std::max(perSecond, 0.01f);
+		burst = std::max(rate * burstSeconds, 1.f);
+		sampleEvery = sampleOneIn;
+	}
+
+	auto Clear() -> void {
+		buckets.Clear();
+		limited.store(0, std::memory_order_relaxed);
+		sampled.store(0, std::memory_order_relaxed);
+	}
+
+	auto Size() const -> size_t { return buckets.Size(); }
+	auto LimitedCount() const -> uint64_t { return limited.load(std::memory_order_relaxed); }
+	auto SampledCount() const -> uint64_t { return sampled.load(std::memory_order_relaxed); }
+
+	// Events dropped rather than sampled. Safe to call from the UI while the hook runs.
+	auto DroppedCount() const -> uint64_t {
+		// Sampled first, as every sampled event was counted as limited before it.
+		const auto s_Sampled = SampledCount();
+		const auto s_Limited = LimitedCount();
+		return s_Limited > s_Sampled ? s_Limited - s_Sampled : 0;
+	}
+
+private:
+	// The counters are only written by the hook's thread but read by the UI.
+	static auto Increment(std::atomic<uint64_t>& counter) -> void {
+		counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	}
+
+	FlatHashMap<Key, Bucket> buckets;
+	float rate = 15.f;
+	float burst = 45.f;
+	uint32_t sampleEvery = 0;
+	std::atomic<uint64_t> limited = 0;
+	std::atomic<uint64_t> sampled = 0;
+};
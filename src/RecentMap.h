@@ -0,0 +1,157 @@
+#pragma once
+#include "FlatHashMap.h"
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+// Hash-indexed map that keeps its values in most-recently-used order through an intrusive list.
+// Lookup, move-to-front, insertion, erasure and eviction of the least recent value are all O(1).
+template <typename K, typename V>
+class RecentMap {
+	struct Node {
+		Node* prev = nullptr;
+		Node* next = nullptr;
+		K key;
+		V value;
+	};
+
+public:
+	template <bool Const>
+	class Iterator {
+		using NodePtr = std::conditional_t<Const, const Node*, Node*>;
+
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = V;
+		using difference_type = std::ptrdiff_t;
+		using pointer = std::conditional_t<Const, const V*, V*>;
+		using reference = std::conditional_t<Const, const V&, V&>;
+
+		Iterator() = default;
+		explicit Iterator(NodePtr node) : node(node) {}
+
+		auto operator*() const -> reference { return node->value; }
+		auto operator->() const -> pointer { return &node->value; }
+		auto operator++() -> Iterator& { node = node->next; return *this; }
+		auto operator++(int) -> Iterator { auto tmp = *this; node = node->next; return tmp; }
+		auto operator==(const Iterator& other) const -> bool { return node == other.node; }
+
+	private:
+		NodePtr node = nullptr;
+	};
+
+	using iterator = Iterator<false>;
+	using const_iterator = Iterator<true>;
+
+	RecentMap() = default;
+	RecentMap(const RecentMap&) = delete;
+	RecentMap& operator=(const RecentMap&) = delete;
+
+	~RecentMap() {
+		this->Clear();
+	}
+
+	auto Find(const K& key) -> V* {
+		auto node = index.Find(key);
+		return node ? &(*node)->value : nullptr;
+	}
+
+	auto Find(const K& key) const -> const V* {
+		auto node = index.Find(key);
+		return node ? &(*node)->value : nullptr;
+	}
+
+	// Moves the value for `key` to the front, returns it or nullptr if there isn't one.
+	auto Touch(const K& key) -> V* {
+		auto node = index.Find(key);
+		if (!node) return nullptr;
+		this->Unlink(*node);
+		this->LinkFront(*node);
+		return &(*node)->value;
+	}
+
+	// Inserts a default-constructed value at the front. `key` must not already be present.
+	auto EmplaceFront(const K& key) -> V& {
+		auto node = new Node{ nullptr, nullptr, key, V{} };
+		index.Insert(key, node);
+		this->LinkFront(node);
+		++count;
+		return node->value;
+	}
+
+	// Moves the least recent value to the front under `key` and returns it, keeping whatever storage it owns
+	// for the caller to reinitialize. `key` must not already be present and the map must not be empty.
+	auto RecycleBack(const K& key) -> V& {
+		auto node = tail;
+		index.Erase(node->key);
+		this->Unlink(node);
+		node->key = key;
+		index.Insert(key, node);
+		this->LinkFront(node);
+		return node->value;
+	}
+
+	auto Erase(const K& key) -> bool {
+		auto node = index.Find(key);
+		if (!node) return false;
+		auto ptr = *node;
+		index.Erase(key);
+		this->Unlink(ptr);
+		--count;
+		delete ptr;
+		return true;
+	}
+
+	auto Back() -> V* {
+		return tail ? &tail->value : nullptr;
+	}
+
+	auto PopBack() -> void {
+		if (tail) this->Erase(tail->key);
+	}
+
+	auto Clear() -> void {
+		for (auto node = head; node;) {
+			auto next = node->next;
+			delete node;
+			node = next;
+		}
+
+		head = tail = nullptr;
+		index.Clear();
+		count = 0;
+	}
+
+	auto Size() const -> size_t { return count; }
+	auto Empty() const -> bool { return count == 0; }
+	// Bytes held by the nodes and the index, not counting anything the values point to.
+	auto MemoryUsage() const -> size_t { return count * sizeof(Node) + index.MemoryUsage(); }
+
+	auto begin() -> iterator { return iterator(head); }
+	auto end() -> iterator { return iterator(); }
+	auto begin() const -> const_iterator { return const_iterator(head); }
+	auto end() const -> const_iterator { return const_iterator(); }
+
+private:
+	auto LinkFront(Node* node) -> void {
+		node->prev = nullptr;
+		node->next = head;
+		if (head) head->prev = node;
+		head = node;
+		if (!tail) tail = node;
+	}
+
+	auto Unlink(Node* node) -> void {
+		if (node->prev) node->prev->next = node->next;
+		else head = node->next;
+		if (node->next) node->next->prev = node->prev;
+		else tail = node->prev;
+		node->prev = node->next = nullptr;
+	}
+
+	FlatHashMap<K, Node*> index;
+	Node* head = nullptr;
+	Node* tail = nullptr;
+	size_t count = 0;
+};
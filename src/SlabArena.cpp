@@ -0,0 +1,85 @@
+#include "SlabArena.h"
+#include <new>
+
+SlabArena::~SlabArena() {
+	for (auto slab : slabs)
+		::operator delete(slab, std::align_val_t(SlabAlignment));
+}
+
+auto SlabArena::Global() -> SlabArena& {
+	static SlabArena s_Arena;
+	return s_Arena;
+}
+
+// Increments a counter that only the allocating thread writes to.
+static auto Increment(std::atomic<uint64_t>& counter) -> void {
+	counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+auto SlabArena::Allocate(size_t size, size_t alignment) -> void* {
+	Increment(allocations);
+
+	if (size > MaxBlockSize || alignment > SlabAlignment) {
+		Increment(oversized);
+		return ::operator new(size, std::align_val_t(alignment));
+	}
+
+	const auto s_Class = ClassFor(size, alignment);
+	const auto s_BlockSize = MinBlockSize << s_Class;
+	auto& sizeClass = classes[s_Class];
+
+	if (!sizeClass.local)
+		sizeClass.local = sizeClass.returned.exchange(nullptr, std::memory_order_acquire);
+
+	if (auto block = sizeClass.local) {
+		sizeClass.local = block->next;
+		Increment(reused);
+		return block;
+	}
+
+	Increment(carved);
+	return this->Carve(s_BlockSize);
+}
+
+auto SlabArena::Carve(size_t blockSize) -> void* {
+	// Blocks are aligned to their size up to the slab's alignment, which covers any alignment they were
+	// rounded up for. Whatever is left at the end of a slab too small for the block is skipped.
+	const auto s_Alignment = std::min(blockSize, SlabAlignment);
+	auto pos = reinterpret_cast<std::byte*>((reinterpret_cast<uintptr_t>(bumpPos) + s_Alignment - 1) & ~(s_Alignment - 1));
+
+	if (!bumpPos || pos + blockSize > bumpEnd) {
+		pos = static_cast<std::byte*>(::operator new(SlabSize, std::align_val_t(SlabAlignment)));
+		slabs.push_back(pos);
+		slabCount.store(slabs.size(), std::memory_order_relaxed);
+		bumpEnd = pos + SlabSize;
+	}
+
+	bumpPos = pos + blockSize;
+	return pos;
+}
+
+auto SlabArena::Free(void* block, size_t size, size_t alignment) -> void {
+	if (!block) return;
+
+	if (size > MaxBlockSize || alignment > SlabAlignment) {
+		::operator delete(block, std::align_val_t(alignment));
+		return;
+	}
+
+	auto& sizeClass = classes[ClassFor(size, alignment)];
+	auto freeBlock = static_cast<FreeBlock*>(block);
+
+	// Only ever pushed to here and taken as a whole, so there's no ABA problem.
+	freeBlock->next = sizeClass.returned.load(std::memory_order_relaxed);
+	while (!sizeClass.returned.compare_exchange_weak(freeBlock->next, freeBlock, std::memory_order_release, std::memory_order_relaxed));
+}
+
+auto SlabArena::GetStats() const -> Stats {
+	Stats stats;
+	stats.allocations = allocations.load(std::memory_order_relaxed);
+	stats.reused = reused.load(std::memory_order_relaxed);
+	stats.carved = carved.load(std::memory_order_relaxed);
+	stats.oversized = oversized.load(std::memory_order_relaxed);
+	stats.slabBytes = slabCount.load(std::memory_order_relaxed) * SlabSize;
+	return stats;
+}
@@ -0,0 +1,112 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Allocator for captured call data, which is allocated for every accepted call and freed when the call
+// drops out of its pin's history. Blocks are carved from 64 KiB slabs with a bump pointer and rounded up
+// to a power of two, and freed blocks go onto a free list for their size to be handed out again. Once the
+// history has filled up, capturing a call doesn't touch the heap, so it doesn't contend with the game.
+// Slabs are kept until the arena is destroyed.
+//
+// Only one thread may allocate at a time (the game thread), but blocks can be freed from any thread as
+// calls are often released when the UI lets go of a snapshot.
+class SlabArena {
+public:
+	static constexpr size_t SlabSize = 64 * 1024;
+	static constexpr size_t SlabAlignment = 64;
+	static constexpr size_t MinBlockSize = 16;
+	static constexpr size_t MaxBlockSize = 4096;
+
+	struct Stats {
+		uint64_t allocations = 0;
+		// Served from a free list, carved from a slab, or too large and passed on to the heap.
+		uint64_t reused = 0;
+		uint64_t carved = 0;
+		uint64_t oversized = 0;
+		size_t slabBytes = 0;
+
+		// Share of allocations that didn't go to the heap.
+		auto HitRate() const -> double {
+			return allocations ? static_cast<double>(reused + carved) / allocations : 1.0;
+		}
+	};
+
+	SlabArena() = default;
+	SlabArena(const SlabArena&) = delete;
+	SlabArena& operator=(const SlabArena&) = delete;
+	~SlabArena();
+
+	static auto Global() -> SlabArena&;
+
+	auto Allocate(size_t size, size_t alignment) -> void*;
+	// Takes the same size and alignment the block was allocated with.
+	auto Free(void* block, size_t size, size_t alignment) -> void;
+
+	// Bytes a block of this size actually takes, for memory accounting.
+	static constexpr auto BlockSize(size_t size, size_t alignment) -> size_t {
+		if (size > MaxBlockSize || alignment > SlabAlignment)
+			return size;
+
+		return MinBlockSize << ClassFor(size, alignment);
+	}
+
+	auto GetStats() const -> Stats;
+
+private:
+	static constexpr size_t ClassCount = 9;
+
+	struct FreeBlock {
+		FreeBlock* next;
+	};
+
+	struct SizeClass {
+		// Only used by the allocating thread. Blocks freed by any thread are pushed to `returned`, which is
+		// taken over as a whole once `local` runs out.
+		FreeBlock* local = nullptr;
+		std::atomic<FreeBlock*> returned = nullptr;
+	};
+
+	static constexpr auto ClassFor(size_t size, size_t alignment) -> size_t {
+		const auto s_BlockSize = std::bit_ceil(std::max({ size, alignment, MinBlockSize }));
+		return static_cast<size_t>(std::countr_zero(s_BlockSize) - std::countr_zero(MinBlockSize));
+	}
+	auto Carve(size_t blockSize) -> void*;
+
+	std::array<SizeClass, ClassCount> classes;
+	std::vector<std::byte*> slabs;
+	std::atomic<size_t> slabCount = 0;
+	std::byte* bumpPos = nullptr;
+	std::byte* bumpEnd = nullptr;
+	// Only written by the allocating thread, so they are updated without read-modify-write operations.
+	std::atomic<uint64_t> allocations = 0;
+	std::atomic<uint64_t> reused = 0;
+	std::atomic<uint64_t> carved = 0;
+	std::atomic<uint64_t> oversized = 0;
+};
+
+// Standard allocator over the global arena, for allocate_shared.
+template <typename T>
+struct SlabAllocator {
+	using value_type = T;
+
+	SlabAllocator() = default;
+
+	template <typename U>
+	SlabAllocator(const SlabAllocator<U>&) {}
+
+	auto allocate(size_t n) -> T* {
+		return static_cast<T*>(SlabArena::Global().Allocate(n * sizeof(T), alignof(T)));
+	}
+
+	auto deallocate(T* p, size_t n) -> void {
+		SlabArena::Global().Free(p, n * sizeof(T), alignof(T));
+	}
+
+	template <typename U>
+	auto operator==(const SlabAllocator<U>&) const -> bool { return true; }
+};
@@ -0,0 +1,223 @@
+#pragma once
+#include "FlatHashMap.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <variant>
+#include <vector>
+
+// Space-Saving top-K sketch: approximate counts of the most frequent keys of a stream in fixed memory.
+// Once all counters are in use, a new key takes over the smallest counter and inherits its count as its
+// error, so every count is an overestimate by at most its error. Any key seen more than Total() / Capacity()
+// times is guaranteed to be tracked. Each counter also carries a `V` for the caller, reset whenever its key changes.
+template <typename K, typename V = std::monostate, typename Hash = FlatHash<K>>
+class SpaceSaving {
+public:
+	struct Counter {
+		K key{};
+		V value{};
+		uint64_t count = 0;
+		uint64_t error = 0;
+
+		// Lowest the key's true count can be.
+		auto Guaranteed() const -> uint64_t { return count - error; }
+	};
+
+	explicit SpaceSaving(size_t capacity) : capacity(std::max<size_t>(capacity, 1)), index(capacity) {
+		counters.reserve(this->capacity);
+		nodes.reserve(this->capacity);
+		buckets.reserve(this->capacity + 1);
+	}
+
+	// Counts `weight` occurrences of `key`. The bool is true if the key wasn't being tracked before.
+	auto Add(const K& key, uint64_t weight = 1) -> std::pair<Counter*, bool> {
+		total += weight;
+
+		if (auto slot = index.Find(key)) {
+			this->Increment(*slot, weight);
+			return { &counters[*slot], false };
+		}
+
+		if (counters.size() < capacity) {
+			const auto slot = static_cast<uint32_t>(counters.size());
+			counters.push_back({ key, V{}, weight, 0 });
+			nodes.push_back({});
+			index.Insert(key, slot);
+			this->Link(slot, None);
+			return { &counters[slot], true };
+		}
+
+		// Replace the key with the smallest count, which is any counter of the first bucket.
+		const auto slot = buckets[minBucket].head;
+		auto& counter = counters[slot];
+		index.Erase(counter.key);
+		index.Insert(key, slot);
+		counter.key = key;
+		counter.value = V{};
+		counter.error = counter.count;
+		this->Increment(slot, weight);
+		return { &counter, true };
+	}
+
+	auto Find(const K& key) const -> const Counter* {
+		auto slot = index.Find(key);
+		return slot ? &counters[*slot] : nullptr;
+	}
+
+	// Counters in no particular order.
+	auto Counters() const -> const std::vector<Counter>& { return counters; }
+
+	// Visits the key and caller data of every counter, which unlike the counts may be modified.
+	template <typename F>
+	auto ForEachValue(F&& fn) -> void {
+		for (auto& counter : counters)
+			fn(counter.key, counter.value);
+	}
+
+	// Up to `n` counters with the highest counts, highest first.
+	auto Top(size_t n) const -> std::vector<Counter> {
+		return this->Top(n, [](const Counter&) { return true; });
+	}
+
+	// Up to `n` of the counters `keep` accepts with the highest counts, highest first.
+	template <typename F>
+	auto Top(size_t n, F&& keep) const -> std::vector<Counter> {
+		std::vector<Counter> top;
+		top.reserve(counters.size());
+		for (const auto& counter : counters) {
+			if (keep(counter))
+				top.push_back(counter);
+		}
+
+		n = std::min(n, top.size());
+		std::partial_sort(top.begin(), top.begin() + n, top.end(), [](const Counter& a, const Counter& b) {
+			return a.count > b.count;
+		});
+		top.resize(n);
+		return top;
+	}
+
+	auto Clear() -> void {
+		counters.clear();
+		nodes.clear();
+		buckets.clear();
+		freeBuckets.clear();
+		minBucket = None;
+		index.Clear();
+		total = 0;
+	}
+
+	// Number of occurrences counted, tracked or not.
+	auto Total() const -> uint64_t { return total; }
+	auto Size() const -> size_t { return counters.size(); }
+	auto Capacity() const -> size_t { return capacity; }
+	// Upper bound on the count of any key that isn't tracked, and on the error of any that is.
+	auto MaxError() const -> uint64_t {
+		return counters.size() < capacity ? 0 : buckets[minBucket].count;
+	}
+
+	auto MemoryUsage() const -> size_t {
+		return counters.capacity() * sizeof(Counter) + nodes.capacity() * sizeof(Node) + buckets.capacity() * sizeof(Bucket)
+			+ freeBuckets.capacity() * sizeof(uint32_t) + index.MemoryUsage();
+	}
+
+private:
+	static constexpr uint32_t None = ~uint32_t(0);
+
+	// Counters are grouped into buckets of equal count, kept in a list from the smallest count up. Adding 1
+	// moves a counter at most one bucket along, so unlike a heap the cost doesn't depend on the capacity.
+	struct Bucket {
+		uint64_t count = 0;
+		uint32_t head = None;
+		uint32_t prev = None;
+		uint32_t next = None;
+	};
+
+	// Links of a counter within its bucket.
+	struct Node {
+		uint32_t bucket = None;
+		uint32_t prev = None;
+		uint32_t next = None;
+	};
+
+	auto Increment(uint32_t slot, uint64_t weight) -> void {
+		auto& counter = counters[slot];
+		auto& node = nodes[slot];
+		counter.count += weight;
+
+		// Alone in its bucket with no bucket in the way, which is the usual case for the busiest keys.
+		if (node.prev == None && node.next == None) {
+			auto& bucket = buckets[node.bucket];
+			if (bucket.next == None || buckets[bucket.next].count > counter.count) {
+				bucket.count = counter.count;
+				return;
+			}
+		}
+
+		this->Link(slot, this->Unlink(slot));
+	}
+
+	// Adds a counter that isn't in any bucket to the one for its count, searching forward from `prev`, a bucket
+	// with a smaller count, or from the first bucket if there's none.
+	auto Link(uint32_t slot, uint32_t prev) -> void {
+		const auto count = counters[slot].count;
+		auto next = prev == None ? minBucket : buckets[prev].next;
+
+		while (next != None && buckets[next].count < count) {
+			prev = next;
+			next = buckets[next].next;
+		}
+
+		auto bucket = next;
+
+		if (next == None || buckets[next].count != count) {
+			if (freeBuckets.empty()) {
+				bucket = static_cast<uint32_t>(buckets.size());
+				buckets.emplace_back();
+			}
+			else {
+				bucket = freeBuckets.back();
+				freeBuckets.pop_back();
+			}
+
+			buckets[bucket] = { count, None, prev, next };
+			(prev == None ? minBucket : buckets[prev].next) = bucket;
+			if (next != None) buckets[next].prev = bucket;
+		}
+
+		auto& head = buckets[bucket].head;
+		nodes[slot] = { bucket, None, head };
+		if (head != None) nodes[head].prev = slot;
+		head = slot;
+	}
+
+	// Removes a counter from its bucket, freeing the bucket if it was the last one in it. Returns a bucket with a
+	// smaller count than the counter had, to search forward from when linking it again.
+	auto Unlink(uint32_t slot) -> uint32_t {
+		const auto& node = nodes[slot];
+		const auto bucket = node.bucket;
+
+		(node.prev == None ? buckets[bucket].head : nodes[node.prev].next) = node.next;
+		if (node.next != None) nodes[node.next].prev = node.prev;
+
+		if (buckets[bucket].head != None)
+			return bucket;
+
+		const auto prev = buckets[bucket].prev;
+		const auto next = buckets[bucket].next;
+		(prev == None ? minBucket : buckets[prev].next) = next;
+		if (next != None) buckets[next].prev = prev;
+		freeBuckets.push_back(bucket);
+		return prev;
+	}
+
+	size_t capacity;
+	std::vector<Counter> counters;
+	std::vector<Node> nodes;
+	std::vector<Bucket> buckets;
+	std::vector<uint32_t> freeBuckets;
+	uint32_t minBucket = None;
+	FlatHashMap<K, uint32_t, Hash> index;
+	uint64_t total = 0;
+};
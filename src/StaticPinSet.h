@@ -0,0 +1,37 @@
+#pragma once
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+// Compile-time open-addressed set of pin IDs.
+// The table is kept at most a quarter full, so a miss almost always costs one multiply and one load.
+template <size_t N>
+class StaticPinSet {
+public:
+	static constexpr size_t TableSize = std::bit_ceil(N * 4);
+
+	constexpr explicit StaticPinSet(const std::array<uint32_t, N>& pins) {
+		for (const auto pin : pins) {
+			auto i = Slot(pin);
+			while (used[i] && keys[i] != pin)
+				i = (i + 1) & (TableSize - 1);
+			keys[i] = pin;
+			used[i] = true;
+		}
+	}
+
+	constexpr auto Contains(uint32_t pin) const -> bool {
+		for (auto i = Slot(pin); used[i]; i = (i + 1) & (TableSize - 1))
+			if (keys[i] == pin) return true;
+		return false;
+	}
+
+private:
+	static constexpr auto Slot(uint32_t pin) -> size_t {
+		return static_cast<uint32_t>(pin * 0x9e3779b1u) >> (32 - (std::bit_width(TableSize) - 1));
+	}
+
+	std::array<uint32_t, TableSize> keys{};
+	std::array<bool, TableSize> used{};
+};
@@ -0,0 +1,74 @@
+#include "StringInterner.h"
+#include <cstring>
+#include <mutex>
+
+StringInterner::StringInterner() {
+	strings.push_back("");
+}
+
+auto StringInterner::Global() -> StringInterner& {
+	static StringInterner s_Interner;
+	return s_Interner;
+}
+
+auto StringInterner::Intern(std::string_view str) -> Symbol {
+	if (str.empty()) return 0;
+
+	{
+		auto sharedLock = std::shared_lock(lock);
+		if (auto symbol = ids.Find(str))
+			return *symbol;
+	}
+
+	auto uniqueLock = std::unique_lock(lock);
+
+	if (auto symbol = ids.Find(str))
+		return *symbol;
+
+	// Key the entry with the stored copy, the caller's view may not outlive this call.
+	const auto stored = this->Store(str);
+	const auto symbol = static_cast<Symbol>(strings.size());
+	strings.push_back(stored);
+	ids.Insert(stored, symbol);
+	return symbol;
+}
+
+auto StringInterner::Lookup(Symbol symbol) const -> std::string_view {
+	auto sharedLock = std::shared_lock(lock);
+	return symbol < strings.size() ? strings[symbol] : std::string_view("");
+}
+
+auto StringInterner::Size() const -> size_t {
+	auto sharedLock = std::shared_lock(lock);
+	return strings.size();
+}
+
+auto StringInterner::MemoryUsage() const -> size_t {
+	auto sharedLock = std::shared_lock(lock);
+	return storedBytes + ids.MemoryUsage() + strings.capacity() * sizeof(std::string_view);
+}
+
+auto StringInterner::Store(std::string_view str) -> std::string_view {
+	const auto size = str.size() + 1;
+	char* dest;
+
+	if (size > ChunkSize / 4) {
+		// Large strings get their own allocation so they don't waste the rest of a chunk.
+		dest = largeStrings.emplace_back(std::make_unique<char[]>(size)).get();
+		storedBytes += size;
+	}
+	else {
+		if (chunkUsed + size > ChunkSize) {
+			chunks.push_back(std::make_unique<char[]>(ChunkSize));
+			chunkUsed = 0;
+			storedBytes += ChunkSize;
+		}
+
+		dest = chunks.back().get() + chunkUsed;
+		chunkUsed += size;
+	}
+
+	std::memcpy(dest, str.data(), str.size());
+	dest[str.size()] = '\0';
+	return { dest, str.size() };
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include "FlatHashMap.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <string_view>
+#include <vector>
+
+// Compact handle for an interned string. Symbol 0 is always the empty string.
+using Symbol = uint32_t;
+
+// Deduplicates names (types, entities, properties, pins) into stable, null-terminated storage.
+// Interning is expected to happen on the game thread, lookups may happen from any thread.
+class StringInterner {
+public:
+	StringInterner();
+	StringInterner(const StringInterner&) = delete;
+	StringInterner& operator=(const StringInterner&) = delete;
+
+	static auto Global() -> StringInterner&;
+
+	auto Intern(std::string_view str) -> Symbol;
+	auto Lookup(Symbol symbol) const -> std::string_view;
+
+	auto CStr(Symbol symbol) const -> const char* {
+		return this->Lookup(symbol).data();
+	}
+
+	auto Size() const -> size_t;
+	auto MemoryUsage() const -> size_t;
+
+private:
+	static constexpr size_t ChunkSize = 64 * 1024;
+
+	auto Store(std::string_view str) -> std::string_view;
+
+	mutable std::shared_mutex lock;
+	FlatHashMap<std::string_view, Symbol> ids;
+	std::vector<std::string_view> strings;
+	std::vector<std::unique_ptr<char[]>> chunks;
+	std::vector<std::unique_ptr<char[]>> largeStrings;
+	size_t chunkUsed = ChunkSize;
+	size_t storedBytes = 0;
+};
+
+inline auto Intern(std::string_view str) -> Symbol {
+	return StringInterner::Global().Intern(str);
+}
+
+inline auto SymbolStr(Symbol symbol) -> const char* {
+	return StringInterner::Global().CStr(symbol);
+}
+
+inline auto SymbolView(Symbol symbol) -> std::string_view {
+	return StringInterner::Global().Lookup(symbol);
+}
@@ -0,0 +1,672 @@
+#include "Trigger.h"
+#include <ResourceLib_HM3.h>
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <format>
+#include <limits>
+
+using namespace std::string_view_literals;
+
+// Recursive descent parser building a small tree, which is reordered and then flattened into the bytecode.
+struct Trigger::Parser {
+	// Tests from cheapest to most expensive to evaluate, which is the order chains run them in.
+	enum class Cost : uint8 {
+		Pin,
+		EntityType,
+		Data,
+		Property,
+	};
+
+	struct Node {
+		enum class Type : uint8 {
+			Test,
+			Not,
+			And,
+			Or,
+		};
+
+		Type type = Type::Test;
+		// Cost of the test, or of the most expensive test below the node.
+		Cost cost = Cost::Pin;
+		Instruction test{ Op::Pin };
+		std::vector<Node> children = {};
+	};
+
+	Trigger& trigger;
+	const PinResolver& resolvePin;
+	std::string_view text;
+	size_t pos = 0;
+
+	auto Fail(std::string_view message) -> std::nullopt_t {
+		if (trigger.error.empty())
+			trigger.error = std::format("{} at column {}", message, pos + 1);
+		return std::nullopt;
+	}
+
+	auto SkipSpace() -> void {
+		while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t' || text[pos] == '\r' || text[pos] == '\n'))
+			++pos;
+	}
+
+	auto AtEnd() -> bool {
+		SkipSpace();
+		return pos == text.size();
+	}
+
+	auto Peek(std::string_view token) -> bool {
+		SkipSpace();
+		return text.substr(pos).starts_with(token);
+	}
+
+	auto Accept(std::string_view token) -> bool {
+		if (!Peek(token)) return false;
+		pos += token.size();
+		return true;
+	}
+
+	static auto IsIdentifierChar(char c, bool first) -> bool {
+		return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' || (!first && c >= '0' && c <= '9');
+	}
+
+	auto ParseIdentifier() -> std::string_view {
+		SkipSpace();
+		const auto s_Start = pos;
+		while (pos < text.size() && IsIdentifierChar(text[pos], pos == s_Start))
+			++pos;
+		return text.substr(s_Start, pos - s_Start);
+	}
+
+	auto ParseString(std::string& out) -> bool {
+		if (!Accept("\"")) return false;
+
+		out.clear();
+
+		while (pos < text.size() && text[pos] != '"') {
+			if (text[pos] == '\\' && pos + 1 < text.size())
+				++pos;
+			out.push_back(text[pos++]);
+		}
+
+		if (pos == text.size()) {
+			Fail("Unterminated string");
+			return false;
+		}
+
+		++pos;
+		return true;
+	}
+
+	auto ParseNumber(double& out) -> bool {
+		SkipSpace();
+
+		const auto* s_Begin = text.data() + pos;
+		const auto* s_End = text.data() + text.size();
+		const auto s_Negative = s_Begin != s_End && *s_Begin == '-';
+		const auto* s_Digits = s_Negative ? s_Begin + 1 : s_Begin;
+
+		// from_chars would also take "inf" and "nan", which may well be the start of a pin name.
+		if (s_Digits == s_End || !((*s_Digits >= '0' && *s_Digits <= '9') || *s_Digits == '.'))
+			return false;
+
+		// Hexadecimal is handy for pin and enum values copied from elsewhere.
+		if (s_End - s_Digits > 2 && s_Digits[0] == '0' && (s_Digits[1] == 'x' || s_Digits[1] == 'X')) {
+			uint64 value = 0;
+			const auto [ptr, ec] = std::from_chars(s_Digits + 2, s_End, value, 16);
+			if (ec != std::errc()) return false;
+			out = s_Negative ? -static_cast<double>(value) : static_cast<double>(value);
+			pos = ptr - text.data();
+			return true;
+		}
+
+		const auto [ptr, ec] = std::from_chars(s_Begin, s_End, out);
+		if (ec != std::errc()) return false;
+		pos = ptr - text.data();
+		return true;
+	}
+
+	auto ParseCompare() -> Compare {
+		static constexpr std::pair<std::string_view, Compare> s_Operators[] = {
+			{ "=="sv, Compare::Equal },
+			{ "!="sv, Compare::NotEqual },
+			{ "!~"sv, Compare::NotMatches },
+			{ "<="sv, Compare::LessEqual },
+			{ ">="sv, Compare::GreaterEqual },
+			{ "<"sv, Compare::Less },
+			{ ">"sv, Compare::Greater },
+			{ "~"sv, Compare::Matches },
+		};
+
+		for (const auto& [token, compare] : s_Operators) {
+			if (Accept(token))
+				return compare;
+		}
+
+		return Compare::Truthy;
+	}
+
+	auto ParseOr() -> std::optional<Node> {
+		return ParseChain(Node::Type::Or, "||");
+	}
+
+	auto ParseAnd() -> std::optional<Node> {
+		return ParseChain(Node::Type::And, "&&");
+	}
+
+	auto ParseChain(Node::Type type, std::string_view token) -> std::optional<Node> {
+		Node node{ type };
+
+		do {
+			auto child = type == Node::Type::Or ? ParseAnd() : ParseUnary();
+			if (!child) return std::nullopt;
+
+			// Nested chains of the same kind are flattened so their tests are ordered together.
+			if (child->type == type)
+				std::move(child->children.begin(), child->children.end(), std::back_inserter(node.children));
+			else
+				node.children.push_back(std::move(*child));
+		} while (Accept(token));
+
+		if (node.children.size() == 1)
+			return std::move(node.children.front());
+
+		// Tests have no side effects, so reordering them only changes how early a chain is cut short.
+		std::stable_sort(node.children.begin(), node.children.end(), [](const Node& a, const Node& b) {
+			return a.cost < b.cost;
+		});
+
+		node.cost = node.children.back().cost;
+		return node;
+	}
+
+	auto ParseUnary() -> std::optional<Node> {
+		if (Accept("!")) {
+			auto child = ParseUnary();
+			if (!child) return std::nullopt;
+
+			Node node{ Node::Type::Not, child->cost };
+			node.children.push_back(std::move(*child));
+			return node;
+		}
+
+		if (Accept("(")) {
+			auto node = ParseOr();
+			if (!node) return std::nullopt;
+			if (!Accept(")")) return Fail("Expected ')'");
+			return node;
+		}
+
+		return ParseTest();
+	}
+
+	auto ParseTest() -> std::optional<Node> {
+		const auto s_Start = pos;
+		const auto s_Operand = ParseIdentifier();
+
+		if (s_Operand == "pin")
+			return ParsePinTest();
+		if (s_Operand == "entityType")
+			return ParseTypeTest();
+
+		if (s_Operand == "data") {
+			ValueTest test;
+			if (!ParseValueTest(test)) return std::nullopt;
+
+			trigger.dataTests.push_back(std::move(test));
+			return Node{ Node::Type::Test, Cost::Data, { Op::Data, Compare::Truthy, static_cast<uint16>(trigger.dataTests.size() - 1) } };
+		}
+
+		if (s_Operand == "prop") {
+			PropertyTest test;
+			if (!Accept("[") || !ParseString(test.name)) return Fail("Expected a property name in quotes");
+			if (!Accept("]")) return Fail("Expected ']'");
+			if (!ParseValueTest(test.value)) return std::nullopt;
+
+			trigger.propertyTests.push_back(std::move(test));
+			return Node{ Node::Type::Test, Cost::Property, { Op::Property, Compare::Truthy, static_cast<uint16>(trigger.propertyTests.size() - 1) } };
+		}
+
+		pos = s_Start;
+		SkipSpace();
+		return s_Operand.empty() ? Fail("Expected pin, entityType, data or prop") : Fail(std::format("Unknown operand '{}'", s_Operand));
+	}
+
+	auto ParsePinTest() -> std::optional<Node> {
+		const auto s_Compare = ParseCompare();
+		if (s_Compare != Compare::Equal && s_Compare != Compare::NotEqual)
+			return Fail("Pins can only be compared with == or !=");
+
+		SkipSpace();
+		const auto s_Start = pos;
+		std::string s_Name;
+		double s_Number = 0;
+		std::optional<uint32> s_PinId;
+
+		if (ParseNumber(s_Number)) {
+			if (s_Number != std::floor(s_Number)) {
+				pos = s_Start;
+				return Fail("Pin IDs must be whole numbers");
+			}
+
+			if (s_Number < 0 || s_Number > std::numeric_limits<uint32>::max()) {
+				pos = s_Start;
+				return Fail("Pin ID out of range");
+			}
+
+			s_PinId = static_cast<uint32>(s_Number);
+		}
+		else {
+			if (!ParseString(s_Name)) {
+				if (!trigger.error.empty()) return std::nullopt;
+				s_Name = ParseIdentifier();
+			}
+
+			if (s_Name.empty()) return Fail("Expected a pin name or ID");
+			if (resolvePin) s_PinId = resolvePin(s_Name);
+
+			if (!s_PinId) {
+				pos = s_Start;
+				return Fail(std::format("Unknown pin '{}'", s_Name));
+			}
+		}
+
+		Node node{ Node::Type::Test, Cost::Pin, { Op::Pin, s_Compare } };
+		node.test.pinId = *s_PinId;
+		return node;
+	}
+
+	auto ParseTypeTest() -> std::optional<Node> {
+		TypeTest test;
+		test.compare = ParseCompare();
+
+		if (test.compare != Compare::Equal && test.compare != Compare::NotEqual && test.compare != Compare::Matches && test.compare != Compare::NotMatches)
+			return Fail("Entity types can only be compared with ==, !=, ~ or !~");
+
+		if (!ParseString(test.name)) {
+			if (!trigger.error.empty()) return std::nullopt;
+			test.name = ParseIdentifier();
+		}
+
+		if (test.name.empty()) return Fail("Expected an entity type name");
+
+		test.query = FilterQuery(test.name);
+		if (!test.query.IsValid()) return Fail("Invalid regular expression");
+
+		trigger.typeTests.push_back(std::move(test));
+		return Node{ Node::Type::Test, Cost::EntityType, { Op::EntityType, Compare::Equal, static_cast<uint16>(trigger.typeTests.size() - 1) } };
+	}
+
+	auto ParseValueTest(ValueTest& test) -> bool {
+		if (Accept(".")) {
+			const auto s_Kind = ParseIdentifier();
+
+			if (s_Kind == "bool") test.kind = ValueKind::Bool;
+			else if (s_Kind == "int") test.kind = ValueKind::Int;
+			else if (s_Kind == "float") test.kind = ValueKind::Float;
+			else if (s_Kind == "string") test.kind = ValueKind::String;
+			else {
+				Fail("Expected .bool, .int, .float or .string");
+				return false;
+			}
+		}
+
+		test.compare = ParseCompare();
+		if (test.compare == Compare::Truthy) return true;
+
+		if (ParseString(test.text))
+			test.textLiteral = true;
+		else if (!trigger.error.empty())
+			return false;
+		else if (Accept("true"))
+			test.number = 1;
+		else if (Accept("false"))
+			test.number = 0;
+		else if (!ParseNumber(test.number)) {
+			Fail("Expected a number, true, false or a string in quotes");
+			return false;
+		}
+
+		const auto s_Matching = test.compare == Compare::Matches || test.compare == Compare::NotMatches;
+		const auto s_Ordering = test.compare != Compare::Equal && test.compare != Compare::NotEqual && !s_Matching;
+
+		if (s_Matching && !test.textLiteral) {
+			Fail("~ and !~ need a string in quotes");
+			return false;
+		}
+
+		if (test.textLiteral && (s_Ordering || (test.kind != ValueKind::None && test.kind != ValueKind::String))) {
+			Fail("Only strings can be compared with text");
+			return false;
+		}
+
+		if (!test.textLiteral && test.kind == ValueKind::String) {
+			Fail("Strings can only be compared with text");
+			return false;
+		}
+
+		if (s_Matching) {
+			test.query = FilterQuery(test.text);
+
+			if (!test.query.IsValid()) {
+				Fail("Invalid regular expression");
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	// Each && or || chain jumps past its remaining tests as soon as one decides the result.
+	auto Emit(const Node& node) -> void {
+		auto& code = trigger.code;
+
+		switch (node.type) {
+		case Node::Type::Test:
+			code.push_back(node.test);
+			break;
+		case Node::Type::Not:
+			Emit(node.children.front());
+			code.push_back({ Op::Not });
+			break;
+		case Node::Type::And:
+		case Node::Type::Or: {
+			std::vector<size_t> s_Jumps;
+
+			for (size_t i = 0; i < node.children.size(); ++i) {
+				Emit(node.children[i]);
+
+				if (i + 1 < node.children.size()) {
+					s_Jumps.push_back(code.size());
+					code.push_back({ node.type == Node::Type::And ? Op::JumpIfFalse : Op::JumpIfTrue });
+				}
+			}
+
+			for (const auto jump : s_Jumps)
+				code[jump].arg = static_cast<uint16>(code.size());
+			break;
+		}
+		}
+	}
+};
+
+static std::atomic<uint64> s_NextTriggerId = 1;
+
+Trigger::Trigger(std::string_view text, const PinResolver& resolvePin) : id(s_NextTriggerId.fetch_add(1, std::memory_order_relaxed)) {
+	Parser s_Parser{ *this, resolvePin, text };
+	if (s_Parser.AtEnd()) return;
+
+	auto s_Root = s_Parser.ParseOr();
+
+	if (s_Root && !s_Parser.AtEnd())
+		s_Parser.Fail(std::format("Unexpected '{}'", text[s_Parser.pos]));
+
+	// Every instruction takes at least a character, so this keeps jump targets and test indices within 16 bits.
+	if (text.size() > std::numeric_limits<uint16>::max())
+		s_Parser.Fail("Trigger is too long");
+
+	if (error.empty())
+		s_Parser.Emit(*s_Root);
+
+	// Like an invalid filter, a trigger that doesn't compile lets everything through.
+	if (!error.empty()) {
+		code.clear();
+		typeTests.clear();
+		dataTests.clear();
+		propertyTests.clear();
+	}
+}
+
+auto Trigger::Evaluate(Cache& cache, uint32 pinId, ZEntityRef entity, STypeID* entityType, STypeID* dataType, const void* data) const -> bool {
+	if (cache.triggerId != id) {
+		cache.Clear();
+		cache.triggerId = id;
+		cache.typeResults.resize(typeTests.size());
+		cache.propertySlots.resize(propertyTests.size());
+	}
+
+	auto s_Result = true;
+
+	for (size_t pc = 0; pc < code.size();) {
+		const auto& instruction = code[pc++];
+
+		switch (instruction.op) {
+		case Op::Pin:
+			s_Result = (pinId == instruction.pinId) == (instruction.compare == Compare::Equal);
+			break;
+		case Op::EntityType:
+			s_Result = this->MatchType(cache, instruction.arg, entityType);
+			break;
+		case Op::Data:
+			s_Result = dataTests[instruction.arg].Matches(ReadValue(cache, dataType, data));
+			break;
+		case Op::Property:
+			s_Result = this->MatchProperty(cache, instruction.arg, entity);
+			break;
+		case Op::Not:
+			s_Result = !s_Result;
+			break;
+		case Op::JumpIfFalse:
+			if (!s_Result) pc = instruction.arg;
+			break;
+		case Op::JumpIfTrue:
+			if (s_Result) pc = instruction.arg;
+			break;
+		}
+	}
+
+	return s_Result;
+}
+
+auto Trigger::Cache::Clear() -> void {
+	triggerId = 0;
+	typeResults.clear();
+	propertySlots.clear();
+	valueTypes.Clear();
+}
+
+auto Trigger::ValueTest::Matches(const Value& value) const -> bool {
+	if (value.kind == ValueKind::None || (kind != ValueKind::None && value.kind != kind))
+		return false;
+
+	if (value.kind == ValueKind::String) {
+		switch (compare) {
+		case Compare::Truthy: return !value.text.empty();
+		case Compare::Equal: return textLiteral && value.text == text;
+		case Compare::NotEqual: return textLiteral && value.text != text;
+		case Compare::Matches: return query.Matches(value.text);
+		case Compare::NotMatches: return !query.Matches(value.text);
+		default: return false;
+		}
+	}
+
+	if (textLiteral) return false;
+
+	const auto s_Literal = value.singlePrecision ? static_cast<double>(static_cast<float>(number)) : number;
+
+	switch (compare) {
+	case Compare::Truthy: return value.number != 0;
+	case Compare::Equal: return value.number == s_Literal;
+	case Compare::NotEqual: return value.number != s_Literal;
+	case Compare::Less: return value.number < s_Literal;
+	case Compare::LessEqual: return value.number <= s_Literal;
+	case Compare::Greater: return value.number > s_Literal;
+	case Compare::GreaterEqual: return value.number >= s_Literal;
+	default: return false;
+	}
+}
+
+auto Trigger::GetValueType(Cache& cache, STypeID* type) -> ValueType {
+	if (!type) return {};
+	if (const auto s_Cached = cache.valueTypes.Find(type)) return *s_Cached;
+
+	static constexpr std::pair<std::string_view, ValueType> s_Types[] = {
+		{ "bool"sv, { ValueKind::Bool, 1 } },
+		{ "uint8"sv, { ValueKind::Int, 1 } },
+		{ "int8"sv, { ValueKind::Int, 1, true } },
+		{ "uint16"sv, { ValueKind::Int, 2 } },
+		{ "int16"sv, { ValueKind::Int, 2, true } },
+		{ "uint32"sv, { ValueKind::Int, 4 } },
+		{ "int32"sv, { ValueKind::Int, 4, true } },
+		{ "uint64"sv, { ValueKind::Int, 8 } },
+		{ "int64"sv, { ValueKind::Int, 8, true } },
+		{ "float32"sv, { ValueKind::Float, 4 } },
+		{ "float64"sv, { ValueKind::Float, 8 } },
+		{ "ZString"sv, { ValueKind::String, sizeof(ZString) } },
+	};
+
+	ValueType s_Type;
+
+	if (const auto s_TypeInfo = type->typeInfo()) {
+		const std::string_view s_TypeName = s_TypeInfo->m_pTypeName;
+		const auto it = std::find_if(std::begin(s_Types), std::end(s_Types), [&](const auto& entry) { return entry.first == s_TypeName; });
+
+		if (it != std::end(s_Types))
+			s_Type = it->second;
+		else if (s_TypeInfo->isEnum() && (s_TypeInfo->m_nTypeSize == 1 || s_TypeInfo->m_nTypeSize == 2 || s_TypeInfo->m_nTypeSize == 4))
+			s_Type = { ValueKind::Int, static_cast<uint8>(s_TypeInfo->m_nTypeSize), true };
+	}
+
+	cache.valueTypes.Insert(type, s_Type);
+	return s_Type;
+}
+
+template <typename T>
+static auto Load(const void* data) -> double {
+	T value;
+	std::memcpy(&value, data, sizeof(T));
+	return static_cast<double>(value);
+}
+
+auto Trigger::ReadValue(Cache& cache, STypeID* type, const void* data) -> Value {
+	return data ? ReadValue(GetValueType(cache, type), data) : Value();
+}
+
+auto Trigger::ReadValue(const ValueType& type, const void* data) -> Value {
+	Value value;
+
+	switch (type.kind) {
+	case ValueKind::None:
+		return value;
+	case ValueKind::Bool:
+		value.number = *static_cast<const bool*>(data) ? 1 : 0;
+		break;
+	case ValueKind::Int:
+		switch (type.size) {
+		case 1: value.number = type.isSigned ? Load<int8>(data) : Load<uint8>(data); break;
+		case 2: value.number = type.isSigned ? Load<int16>(data) : Load<uint16>(data); break;
+		case 4: value.number = type.isSigned ? Load<int32>(data) : Load<uint32>(data); break;
+		default: value.number = type.isSigned ? Load<int64>(data) : Load<uint64>(data); break;
+		}
+		break;
+	case ValueKind::Float:
+		value.singlePrecision = type.size == 4;
+		value.number = value.singlePrecision ? Load<float32>(data) : Load<float64>(data);
+		break;
+	case ValueKind::String:
+		value.text = static_cast<const ZString*>(data)->ToStringView();
+		break;
+	}
+
+	value.kind = type.kind;
+	return value;
+}
+
+auto Trigger::MatchType(Cache& cache, size_t testIndex, STypeID* entityType) const -> bool {
+	if (!entityType) return false;
+
+	const auto& test = typeTests[testIndex];
+
+	// The hook only sees type pointers, so each type's name is only looked at the first time it comes by.
+	auto [result, inserted] = cache.typeResults[testIndex].TryEmplace(entityType);
+
+	if (inserted) {
+		const std::string_view s_Name = entityType->typeInfo()->m_pTypeName;
+
+		switch (test.compare) {
+		case Compare::Equal: *result = s_Name == test.name; break;
+		case Compare::NotEqual: *result = s_Name != test.name; break;
+		case Compare::Matches: *result = test.query.Matches(s_Name); break;
+		default: *result = !test.query.Matches(s_Name); break;
+		}
+	}
+
+	return *result;
+}
+
+// Finds a property by the name the properties pane shows for it.
+static auto FindProperty(const TArray<ZEntityProperty>& properties, std::string_view name) -> int32 {
+	for (uint32 i = 0; i < properties.size(); ++i) {
+		const auto& s_Property = properties[i];
+		const auto s_Info = s_Property.m_pType ? s_Property.m_pType->getPropertyInfo() : nullptr;
+		if (!s_Info || !s_Info->m_pType) continue;
+
+		if (s_Info->m_pType->typeInfo()->isResource() || s_Info->m_nPropertyID != s_Property.m_nPropertyId) {
+			const auto s_Name = HM3_GetPropertyName(s_Property.m_nPropertyId);
+			if (std::string_view(s_Name.Data, s_Name.Size) == name) return static_cast<int32>(i);
+		}
+		else if (name == s_Info->m_pName)
+			return static_cast<int32>(i);
+	}
+
+	return -1;
+}
+
+// Whether a slot was filled in for another table that has since taken over the address.
+static auto IsStale(size_t tableSize, int32 index, uint32 propertyId, const TArray<ZEntityProperty>& properties) -> bool {
+	if (properties.size() != tableSize) return true;
+	if (tableSize == 0) return false;
+
+	return properties[index >= 0 ? index : 0].m_nPropertyId != propertyId;
+}
+
+auto Trigger::MatchProperty(Cache& cache, size_t testIndex, ZEntityRef entity) const -> bool {
+	const auto s_EntityType = entity ? entity->GetType() : nullptr;
+	if (!s_EntityType || !s_EntityType->m_pProperties01) return false;
+
+	const auto& test = propertyTests[testIndex];
+	const auto& s_Properties = *s_EntityType->m_pProperties01;
+	auto [slot, inserted] = cache.propertySlots[testIndex].TryEmplace(&s_Properties);
+
+	if (inserted || IsStale(slot->tableSize, slot->index, slot->propertyId, s_Properties)) {
+		*slot = {};
+		slot->index = FindProperty(s_Properties, test.name);
+		slot->tableSize = s_Properties.size();
+
+		if (slot->index >= 0) {
+			const auto& s_Property = s_Properties[slot->index];
+			const auto s_Info = s_Property.m_pType->getPropertyInfo();
+
+			slot->propertyId = s_Property.m_nPropertyId;
+			slot->type = GetValueType(cache, s_Info->m_pType);
+			slot->useGetter = (s_Info->m_nFlags & EPropertyInfoFlags::E_HAS_GETTER_SETTER) != 0;
+		}
+		else if (slot->tableSize > 0)
+			slot->propertyId = s_Properties[0].m_nPropertyId;
+	}
+
+	if (slot->index < 0 || slot->type.kind == ValueKind::None) return false;
+
+	const auto& s_Property = s_Properties[slot->index];
+	auto* s_Source = reinterpret_cast<std::byte*>(entity.m_pEntity) + s_Property.m_nOffset;
+
+	if (!slot->useGetter)
+		return test.value.Matches(ReadValue(slot->type, s_Source));
+
+	// Values behind a getter are read into a local, which only the types the trigger can compare fit in.
+	const auto s_Info = s_Property.m_pType->getPropertyInfo();
+	const auto s_TypeInfo = s_Info->m_pType->typeInfo();
+	alignas(16) std::byte s_Buffer[32];
+
+	if (s_TypeInfo->m_nTypeSize > sizeof(s_Buffer))
+		return false;
+
+	s_Info->get(s_Source, s_Buffer, s_Info->m_nOffset);
+	const auto s_Matches = test.value.Matches(ReadValue(slot->type, s_Buffer));
+
+	if (slot->type.kind == ValueKind::String)
+		s_TypeInfo->m_pTypeFunctions->destruct(s_Buffer);
+
+	return s_Matches;
+}
@@ -0,0 +1,167 @@
+#pragma once
+#include "Filter.h"
+#include "FlatHashMap.h"
+#include <Glacier/ZEntity.h>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Capture condition compiled once into bytecode that the hook runs for every call, e.g.
+//   pin == OnEnter && entityType ~ "Trigger*" && data.float > 0.5 && prop["m_bEnabled"] == true
+//
+// Operands are `pin`, `entityType`, the payload as `data` and property values as `prop["name"]`. The last two
+// take an optional `.bool`, `.int`, `.float` or `.string` suffix that requires the value to be of that kind,
+// and on their own test the value for being non-zero or non-empty. Values are compared with == != < <= > >=
+// against numbers, true/false or "strings", and ~ and !~ match text like the name filters do. Tests combine
+// with && || ! and parentheses.
+//
+// Whatever order the tests are written in, each && and || chain runs them cheapest first: pin, entity type,
+// payload, then properties, so properties are only looked up for calls that got past everything else. A test
+// whose value is missing or of another kind is false.
+//
+// A compiled trigger is never modified. What Evaluate learns about types and property tables goes into a
+// Cache owned by the caller, so a trigger is replaced as a whole rather than edited.
+class Trigger {
+public:
+	// Maps a pin name to its ID, for pins written by name rather than number.
+	using PinResolver = std::function<std::optional<uint32>(std::string_view name)>;
+
+	class Cache;
+
+	Trigger() = default;
+	Trigger(std::string_view text, const PinResolver& resolvePin);
+
+	// Called from the hook. The cache is reset when it was last used with another trigger.
+	auto Evaluate(Cache& cache, uint32 pinId, ZEntityRef entity, STypeID* entityType, STypeID* dataType, const void* data) const -> bool;
+
+	auto MatchesAll() const -> bool { return code.empty(); }
+	auto IsValid() const -> bool { return error.empty(); }
+	auto GetError() const -> std::string_view { return error; }
+
+private:
+	enum class Op : uint8 {
+		Pin,
+		EntityType,
+		Data,
+		Property,
+		Not,
+		// Jumps leave the result of the test before them in place for the chain they cut short.
+		JumpIfFalse,
+		JumpIfTrue,
+	};
+
+	enum class Compare : uint8 {
+		Truthy,
+		Equal,
+		NotEqual,
+		Less,
+		LessEqual,
+		Greater,
+		GreaterEqual,
+		Matches,
+		NotMatches,
+	};
+
+	enum class ValueKind : uint8 {
+		None,
+		Bool,
+		Int,
+		Float,
+		String,
+	};
+
+	struct Instruction {
+		Op op;
+		Compare compare = Compare::Truthy;
+		// Test index or jump target.
+		uint16 arg = 0;
+		uint32 pinId = 0;
+	};
+
+	// How values of a type are read, resolved by type name once.
+	struct ValueType {
+		ValueKind kind = ValueKind::None;
+		uint8 size = 0;
+		bool isSigned = false;
+	};
+
+	struct Value {
+		ValueKind kind = ValueKind::None;
+		// Single precision values are compared against the literal rounded the same way.
+		bool singlePrecision = false;
+		double number = 0;
+		std::string_view text;
+	};
+
+	struct ValueTest {
+		// Kind the value must have, None for any.
+		ValueKind kind = ValueKind::None;
+		Compare compare = Compare::Truthy;
+		bool textLiteral = false;
+		double number = 0;
+		std::string text;
+		FilterQuery query;
+
+		auto Matches(const Value& value) const -> bool;
+	};
+
+	struct TypeTest {
+		Compare compare = Compare::Equal;
+		std::string name;
+		FilterQuery query;
+	};
+
+	// Where a property was found in a table, or that it wasn't, and how to read it. The table's size and the
+	// ID of the property at `index`, or of its first property when not found, are checked on use in case
+	// another table reused the memory.
+	struct PropertySlot {
+		int32 index = -1;
+		uint32 propertyId = 0;
+		size_t tableSize = 0;
+		ValueType type;
+		bool useGetter = false;
+	};
+
+	struct PropertyTest {
+		std::string name;
+		ValueTest value;
+	};
+
+public:
+	// Results of a trigger's type and property lookups, by entity type and property table.
+	class Cache {
+	public:
+		// Needed when the scene changes, as the property tables belong to the loaded scene.
+		auto Clear() -> void;
+
+	private:
+		friend class Trigger;
+
+		// ID of the trigger the results are for, zero for none.
+		uint64 triggerId = 0;
+		// Results of each entity type test by type.
+		std::vector<FlatHashMap<STypeID*, bool>> typeResults;
+		// Slots of each property test by property table.
+		std::vector<FlatHashMap<const TArray<ZEntityProperty>*, PropertySlot>> propertySlots;
+		FlatHashMap<STypeID*, ValueType> valueTypes;
+	};
+
+private:
+	struct Parser;
+
+	static auto GetValueType(Cache& cache, STypeID* type) -> ValueType;
+	static auto ReadValue(Cache& cache, STypeID* type, const void* data) -> Value;
+	static auto ReadValue(const ValueType& type, const void* data) -> Value;
+	auto MatchType(Cache& cache, size_t testIndex, STypeID* entityType) const -> bool;
+	auto MatchProperty(Cache& cache, size_t testIndex, ZEntityRef entity) const -> bool;
+
+	// Sets every compiled trigger apart, so caches can tell which one their results are for.
+	uint64 id = 0;
+	std::vector<Instruction> code;
+	std::vector<TypeTest> typeTests;
+	std::vector<ValueTest> dataTests;
+	std::vector<PropertyTest> propertyTests;
+	std::string error;
+};
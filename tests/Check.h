@@ -0,0 +1,11 @@
+#pragma once
+#include <cstdio>
+
+// Minimal checks for the unit tests, which run as plain executables under CTest. A failed check is reported
+// and the test carries on, main() then returns the number of failures.
+inline int g_CheckFailures = 0;
+
+#define CHECK(condition) \
+	((condition) ? void() : (++g_CheckFailures, std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition), void()))
+
+#define CHECK_RESULT() (g_CheckFailures == 0 ? 0 : (std::fprintf(stderr, "%d checks failed\n", g_CheckFailures), 1))
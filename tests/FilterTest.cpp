@@ -0,0 +1,223 @@
+#include "Check.h"
+#include "Filter.h"
+#include <cctype>
+#include <cstdio>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+static auto Lower(std::string_view text) -> std::string {
+	std::string lower(text);
+	for (auto& c : lower)
+		c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+	return lower;
+}
+
+// Straightforward recursive glob, to check the backtracking one against.
+static auto NaiveGlob(std::string_view pattern, std::string_view name) -> bool {
+	if (pattern.empty()) return name.empty();
+	if (pattern[0] == '*')
+		return NaiveGlob(pattern.substr(1), name) || (!name.empty() && NaiveGlob(pattern, name.substr(1)));
+	if (name.empty() || (pattern[0] != '?' && pattern[0] != name[0])) return false;
+	return NaiveGlob(pattern.substr(1), name.substr(1));
+}
+
+static auto NaiveMatch(std::string_view query, std::string_view name) -> bool {
+	if (query.empty()) return true;
+
+	const auto s_Query = Lower(query);
+	const auto s_Name = Lower(name);
+
+	if (s_Query.find_first_of("*?") != std::string::npos)
+		return NaiveGlob(s_Query, s_Name);
+	return s_Name.find(s_Query) != std::string::npos;
+}
+
+// Names shaped like the game's entity types and pins, in mixed case.
+static auto MakeNames(size_t count, uint32_t seed) -> std::vector<std::string> {
+	static constexpr std::string_view s_Parts[] = {
+		"Z", "Trigger", "Entity", "Volume", "Box", "Timer", "Actor", "On", "Enter", "Exit", "Signal", "Door",
+		"Hitman", "Item", "Sound", "Event", "_", "2", "Bool", "Value",
+	};
+
+	std::mt19937 rng(seed);
+	std::vector<std::string> names;
+	names.reserve(count);
+
+	for (size_t i = 0; i < count; ++i) {
+		std::string name;
+		const auto s_PartCount = 1 + rng() % 5;
+
+		for (size_t p = 0; p < s_PartCount; ++p) {
+			std::string part(s_Parts[rng() % std::size(s_Parts)]);
+
+			if (rng() % 4 == 0)
+				part = Lower(part);
+			else if (rng() % 8 == 0) {
+				for (auto& c : part)
+					c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+			}
+
+			name += part;
+		}
+
+		names.push_back(std::move(name));
+	}
+
+	return names;
+}
+
+static auto TestSubstring() -> void {
+	const FilterQuery query("trigger");
+	CHECK(query.GetMode() == FilterQuery::Mode::Substring);
+	CHECK(query.Matches("ZTriggerEntity"));
+	CHECK(query.Matches("TRIGGER"));
+	CHECK(query.Matches("OnTriggered"));
+	CHECK(!query.Matches("ZTrigEntity"));
+	CHECK(!query.Matches(""));
+
+	const FilterQuery mixed("OnEnter");
+	CHECK(mixed.Matches("onenter"));
+	CHECK(mixed.Matches("Pin_ONENTER_2"));
+	CHECK(!mixed.Matches("OnExit"));
+}
+
+static auto TestGlob() -> void {
+	const FilterQuery query("z*Entity");
+	CHECK(query.GetMode() == FilterQuery::Mode::Glob);
+	CHECK(query.Matches("ZTriggerEntity"));
+	CHECK(query.Matches("zentity"));
+	// A glob covers the whole name rather than a part of it.
+	CHECK(!query.Matches("ZTriggerEntity2"));
+	CHECK(!query.Matches("AZEntity"));
+
+	const FilterQuery single("On???er");
+	CHECK(single.Matches("OnEnter"));
+	CHECK(!single.Matches("OnEnteer"));
+	CHECK(!single.Matches("OnEner"));
+
+	const FilterQuery backtrack("*a*b*a");
+	CHECK(backtrack.Matches("aaBbbA"));
+	CHECK(backtrack.Matches("xAxBxA"));
+	CHECK(!backtrack.Matches("abab"));
+
+	CHECK(FilterQuery("*").Matches(""));
+	CHECK(FilterQuery("*").Matches("Anything"));
+	CHECK(!FilterQuery("?").Matches(""));
+}
+
+static auto TestRegex() -> void {
+	const FilterQuery query("re:^on(enter|exit)$");
+	CHECK(query.GetMode() == FilterQuery::Mode::Regex);
+	CHECK(query.IsValid());
+	CHECK(query.Matches("OnEnter"));
+	CHECK(query.Matches("ONEXIT"));
+	CHECK(!query.Matches("OnEnter2"));
+	CHECK(!query.Matches("Signal"));
+
+	// Without anchors a regex matches anywhere in the name, like a substring.
+	CHECK(FilterQuery("re:t[a-z]+r").Matches("ZTimerEntity"));
+
+	// An invalid expression is reported and filters nothing out.
+	const FilterQuery invalid("re:(unclosed");
+	CHECK(invalid.GetMode() == FilterQuery::Mode::Regex);
+	CHECK(!invalid.IsValid());
+	CHECK(invalid.Matches("ZTriggerEntity"));
+	CHECK(invalid.Matches(""));
+}
+
+static auto TestEmpty() -> void {
+	const FilterQuery query;
+	CHECK(query.MatchesAll());
+	CHECK(query.IsValid());
+	CHECK(query.Matches(""));
+	CHECK(query.Matches("ZTriggerEntity"));
+
+	CHECK(FilterQuery("").MatchesAll());
+	// "re:" on its own is an empty expression, which matches everything but isn't the empty query.
+	CHECK(!FilterQuery("re:").MatchesAll());
+	CHECK(FilterQuery("re:").Matches("ZTriggerEntity"));
+}
+
+static auto TestSymbolFilter() -> void {
+	const auto s_Trigger = Intern("FilterTest_ZTriggerEntity");
+	const auto s_Timer = Intern("FilterTest_ZTimerEntity");
+
+	SymbolFilter filter;
+	CHECK(filter.MatchesAll());
+	CHECK(filter.Matches(s_Trigger) && filter.Matches(s_Timer));
+
+	CHECK(filter.SetQuery("trigger"));
+	CHECK(!filter.SetQuery("trigger"));
+	CHECK(filter.GetQuery() == "trigger");
+	CHECK(filter.Matches(s_Trigger));
+	CHECK(!filter.Matches(s_Timer));
+
+	// Changing the query drops the results cached for the previous one.
+	CHECK(filter.SetQuery("timer"));
+	CHECK(!filter.Matches(s_Trigger));
+	CHECK(filter.Matches(s_Timer));
+
+	// Names interned after results were cached are tested when first seen, not given a stale result.
+	const auto s_Later = Intern("FilterTest_ZTimerEntityLater");
+	const auto s_LaterOther = Intern("FilterTest_ZDoorEntityLater");
+	CHECK(filter.Matches(s_Later));
+	CHECK(!filter.Matches(s_LaterOther));
+	CHECK(filter.Matches(s_Timer));
+
+	CHECK(filter.SetQuery("re:("));
+	CHECK(!filter.IsValid());
+	CHECK(filter.Matches(s_LaterOther));
+
+	CHECK(filter.SetQuery(""));
+	CHECK(filter.MatchesAll());
+	CHECK(filter.Matches(s_Trigger) && filter.Matches(s_LaterOther));
+}
+
+// Runs substring and glob queries over many names, directly and through SymbolFilter, against the naive
+// matcher above.
+static auto TestSyntheticNames() -> void {
+	static constexpr std::string_view s_Queries[] = {
+		"", "e", "trigger", "ONENTER", "entity", "z*", "*entity", "z*entity", "*on*er*", "?imer*", "*_?",
+		"*2*2*", "*door", "hitman", "xyz",
+	};
+
+	const auto s_Names = MakeNames(50000, 7);
+	std::vector<Symbol> symbols;
+	symbols.reserve(s_Names.size());
+	for (const auto& name : s_Names)
+		symbols.push_back(Intern(name));
+
+	SymbolFilter filter;
+
+	for (const auto text : s_Queries) {
+		const FilterQuery query(text);
+		filter.SetQuery(text);
+		size_t mismatches = 0;
+
+		// Twice through the filter, so the second pass runs on cached results.
+		for (int pass = 0; pass < 2; ++pass) {
+			for (size_t i = 0; i < s_Names.size(); ++i) {
+				const auto s_Expected = NaiveMatch(text, s_Names[i]);
+				if (query.Matches(s_Names[i]) != s_Expected || filter.Matches(symbols[i]) != s_Expected)
+					++mismatches;
+			}
+		}
+
+		if (mismatches)
+			std::fprintf(stderr, "query \"%.*s\": %zu mismatches\n", static_cast<int>(text.size()), text.data(), mismatches);
+		CHECK(mismatches == 0);
+	}
+}
+
+int main() {
+	TestSubstring();
+	TestGlob();
+	TestRegex();
+	TestEmpty();
+	TestSymbolFilter();
+	TestSyntheticNames();
+	return CHECK_RESULT();
+}
@@ -0,0 +1,159 @@
+#include "Check.h"
+#include "SpaceSaving.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+// Zipf distributed keys, with a few keys making up most of the stream and a long tail of rare ones.
+static auto MakeSkewedStream(double skew, size_t distinct, size_t length, uint32_t seed) -> std::vector<uint32_t> {
+	std::vector<double> cdf(distinct);
+	double sum = 0;
+
+	for (size_t i = 0; i < distinct; ++i)
+		cdf[i] = sum += 1.0 / std::pow(static_cast<double>(i + 1), skew);
+
+	std::mt19937 rng(seed);
+	std::uniform_real_distribution<double> dist(0, sum);
+	std::vector<uint32_t> stream;
+	stream.reserve(length);
+
+	for (size_t i = 0; i < length; ++i)
+		stream.push_back(static_cast<uint32_t>(std::lower_bound(cdf.begin(), cdf.end(), dist(rng)) - cdf.begin()));
+
+	return stream;
+}
+
+// Checks the guarantees SpaceSaving documents against the exact counts of the stream it was fed.
+static auto CheckBounds(const SpaceSaving<uint32_t>& sketch, const std::unordered_map<uint32_t, uint64_t>& exact) -> void {
+	uint64_t total = 0;
+	for (const auto& [key, count] : exact)
+		total += count;
+
+	CHECK(sketch.Total() == total);
+	CHECK(sketch.Size() == std::min(sketch.Capacity(), exact.size()));
+
+	uint64_t countSum = 0;
+
+	for (const auto& counter : sketch.Counters()) {
+		const auto it = exact.find(counter.key);
+		const auto trueCount = it != exact.end() ? it->second : 0;
+
+		CHECK(counter.count >= trueCount);
+		CHECK(counter.Guaranteed() <= trueCount);
+		CHECK(counter.error <= sketch.MaxError());
+		countSum += counter.count;
+	}
+
+	// Replacing a counter carries its count over, so the counts always add up to the stream length.
+	CHECK(countSum == total);
+	CHECK(sketch.MaxError() <= total / sketch.Capacity());
+
+	// Keys that aren't tracked can't have been seen more often than the smallest counter, so any key seen
+	// more than Total() / Capacity() times is tracked.
+	for (const auto& [key, count] : exact) {
+		if (!sketch.Find(key))
+			CHECK(count <= sketch.MaxError());
+		if (count > total / sketch.Capacity())
+			CHECK(sketch.Find(key) != nullptr);
+	}
+
+	const auto s_Top = sketch.Top(sketch.Capacity());
+	CHECK(s_Top.size() == sketch.Size());
+	CHECK(std::is_sorted(s_Top.begin(), s_Top.end(), [](const auto& a, const auto& b) { return a.count > b.count; }));
+}
+
+static auto TestUnderCapacityIsExact() -> void {
+	SpaceSaving<uint32_t> sketch(16);
+	std::unordered_map<uint32_t, uint64_t> exact;
+
+	for (uint32_t i = 0; i < 1000; ++i) {
+		const auto key = i % 10;
+		const auto [counter, inserted] = sketch.Add(key);
+		CHECK(inserted == (i < 10));
+		CHECK(counter->key == key);
+		++exact[key];
+	}
+
+	CHECK(sketch.MaxError() == 0);
+	for (const auto& counter : sketch.Counters())
+		CHECK(counter.error == 0 && counter.count == exact[counter.key]);
+
+	CheckBounds(sketch, exact);
+}
+
+static auto TestSkewedStreams() -> void {
+	for (const auto skew : { 0.8, 1.1, 1.5 }) {
+		for (const size_t capacity : { 8, 64, 512 }) {
+			SpaceSaving<uint32_t> sketch(capacity);
+			std::unordered_map<uint32_t, uint64_t> exact;
+
+			for (const auto key : MakeSkewedStream(skew, 20000, 200000, static_cast<uint32_t>(capacity))) {
+				sketch.Add(key);
+				++exact[key];
+			}
+
+			CheckBounds(sketch, exact);
+		}
+	}
+}
+
+static auto TestWeightedAdds() -> void {
+	SpaceSaving<uint32_t> sketch(4);
+	std::unordered_map<uint32_t, uint64_t> exact;
+	std::mt19937 rng(42);
+
+	for (int i = 0; i < 5000; ++i) {
+		const auto key = static_cast<uint32_t>(rng() % 40);
+		const auto weight = uint64_t(1) + rng() % 5;
+		sketch.Add(key, weight);
+		exact[key] += weight;
+	}
+
+	CheckBounds(sketch, exact);
+}
+
+static auto TestClear() -> void {
+	SpaceSaving<uint32_t> sketch(2);
+
+	for (uint32_t i = 0; i < 10; ++i)
+		sketch.Add(i);
+
+	sketch.Clear();
+	CHECK(sketch.Size() == 0);
+	CHECK(sketch.Total() == 0);
+	CHECK(sketch.MaxError() == 0);
+
+	std::unordered_map<uint32_t, uint64_t> exact;
+	for (uint32_t i = 0; i < 100; ++i) {
+		sketch.Add(i % 3);
+		++exact[i % 3];
+	}
+
+	CheckBounds(sketch, exact);
+}
+
+static auto TestFilteredTop() -> void {
+	SpaceSaving<uint32_t> sketch(16);
+
+	for (uint32_t key = 0; key < 10; ++key)
+		sketch.Add(key, key + 1);
+
+	// The keys left out don't take up any of the `n` places.
+	const auto s_Odd = sketch.Top(3, [](const auto& counter) { return counter.key % 2 == 1; });
+	CHECK(s_Odd.size() == 3 && s_Odd[0].key == 9 && s_Odd[1].key == 7 && s_Odd[2].key == 5);
+
+	CHECK(sketch.Top(20, [](const auto& counter) { return counter.key < 4; }).size() == 4);
+	CHECK(sketch.Top(20, [](const auto&) { return false; }).empty());
+}
+
+int main() {
+	TestUnderCapacityIsExact();
+	TestSkewedStreams();
+	TestWeightedAdds();
+	TestClear();
+	TestFilteredTop();
+	return CHECK_RESULT();
+}
@@ -0,0 +1,204 @@
+#include "Check.h"
+#include "MockWorld.h"
+#include "Trigger.h"
+#include <charconv>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+// Pins are named "Pin<ID>", like the benchmarks' mock host does.
+static auto ResolvePin(std::string_view name) -> std::optional<uint32> {
+	uint32 pinId = 0;
+	if (!name.starts_with("Pin") || std::from_chars(name.data() + 3, name.data() + name.size(), pinId).ec != std::errc())
+		return std::nullopt;
+	return pinId;
+}
+
+template <typename T>
+static auto SetProperty(ZEntityRef entity, size_t index, const T& value) -> void {
+	const auto& s_Property = (*entity->GetType()->m_pProperties01)[index];
+	*reinterpret_cast<T*>(reinterpret_cast<std::byte*>(entity.m_pEntity) + s_Property.m_nOffset) = value;
+}
+
+struct TestWorld {
+	MockWorld world;
+	STypeID* floatType = world.Type<float32>("float32");
+	STypeID* boolType = world.Type<bool>("bool");
+	STypeID* stringType = world.Type<ZString>("ZString");
+	STypeID* intType = world.Type<int32>("int32");
+	ZEntityRef trigger;
+	ZEntityRef timer;
+
+	TestWorld() {
+		const MockProperty s_Props[] = { { "m_bEnabled", boolType }, { "m_fValue", floatType }, { "m_sName", stringType } };
+		trigger = world.Entity(world.EntityType("ZTriggerEntity", s_Props));
+		timer = world.Entity(world.EntityType("ZTimerEntity", s_Props));
+
+		SetProperty(trigger, 0, true);
+		SetProperty(trigger, 1, 0.7f);
+		SetProperty(trigger, 2, ZString("hello"));
+	}
+
+	static auto TypeOf(ZEntityRef entity) -> STypeID* {
+		return entity ? GetEntityInterfaceType(entity->GetType()) : nullptr;
+	}
+};
+
+struct Call {
+	uint32 pinId = 1;
+	ZEntityRef entity;
+	STypeID* dataType = nullptr;
+	const void* data = nullptr;
+};
+
+// Compiles `text` and evaluates it for `call` twice, the second time from the cache.
+static auto Evaluate(std::string_view text, const Call& call) -> bool {
+	const Trigger s_Trigger(text, &ResolvePin);
+	CHECK(s_Trigger.IsValid());
+
+	Trigger::Cache cache;
+	const auto s_Entity = call.entity;
+	const auto s_First = s_Trigger.Evaluate(cache, call.pinId, s_Entity, TestWorld::TypeOf(s_Entity), call.dataType, call.data);
+	const auto s_Second = s_Trigger.Evaluate(cache, call.pinId, s_Entity, TestWorld::TypeOf(s_Entity), call.dataType, call.data);
+	CHECK(s_First == s_Second);
+	return s_First;
+}
+
+static auto ErrorOf(std::string_view text) -> std::string {
+	const Trigger s_Trigger(text, &ResolvePin);
+	CHECK(!s_Trigger.IsValid());
+	// A trigger that doesn't compile lets everything through.
+	CHECK(s_Trigger.MatchesAll());
+	return std::string(s_Trigger.GetError());
+}
+
+static auto TestPins(TestWorld& w) -> void {
+	CHECK(Trigger("", &ResolvePin).MatchesAll());
+	CHECK(Evaluate("pin == Pin5", { 5, w.trigger }));
+	CHECK(!Evaluate("pin == Pin5", { 6, w.trigger }));
+	CHECK(Evaluate("pin != 5", { 6, w.trigger }));
+	CHECK(Evaluate("pin == 0x10", { 16, w.trigger }));
+	CHECK(Evaluate("pin == \"Pin7\"", { 7, w.trigger }));
+}
+
+static auto TestPrecedence(TestWorld& w) -> void {
+	// && binds tighter than ||.
+	CHECK(Evaluate("pin == 1 || pin == 2 && entityType == ZTimerEntity", { 1, w.trigger }));
+	CHECK(!Evaluate("pin == 1 || pin == 2 && entityType == ZTimerEntity", { 2, w.trigger }));
+	CHECK(Evaluate("pin == 2 && entityType == ZTimerEntity || pin == 1", { 1, w.trigger }));
+	CHECK(Evaluate("(pin == 1 || pin == 2) && entityType == ZTimerEntity", { 2, w.timer }));
+	CHECK(!Evaluate("(pin == 1 || pin == 2) && entityType == ZTimerEntity", { 2, w.trigger }));
+
+	// ! applies to the test or parentheses right after it.
+	CHECK(Evaluate("!pin == 1 && pin == 2", { 2, w.trigger }));
+	CHECK(!Evaluate("!(pin == 1 || pin == 2)", { 2, w.trigger }));
+	CHECK(Evaluate("!(pin == 1 || pin == 2) && entityType != ZTimerEntity", { 3, w.trigger }));
+	CHECK(Evaluate("!!(pin == 3)", { 3, w.trigger }));
+
+	// Tests are reordered cheapest first, which mustn't change the result of nested chains.
+	CHECK(Evaluate("prop[\"m_bEnabled\"] && (pin == 1 || entityType ~ \"ZTimer*\") && pin != 4", { 1, w.trigger }));
+	CHECK(!Evaluate("prop[\"m_bEnabled\"] && (pin == 1 || entityType ~ \"ZTimer*\") && pin != 4", { 2, w.trigger }));
+	CHECK(Evaluate("prop[\"missing\"] == 1 || pin == 1", { 1, w.trigger }));
+	CHECK(!Evaluate("prop[\"missing\"] == 1 || pin == 2", { 1, w.trigger }));
+}
+
+static auto TestEntityTypes(TestWorld& w) -> void {
+	CHECK(Evaluate("entityType == ZTriggerEntity", { 1, w.trigger }));
+	CHECK(!Evaluate("entityType == ZTriggerEntity", { 1, w.timer }));
+	CHECK(Evaluate("entityType != \"ZTriggerEntity\"", { 1, w.timer }));
+	CHECK(Evaluate("entityType ~ \"trigger\"", { 1, w.trigger }));
+	CHECK(Evaluate("entityType !~ \"ZTrigger*\"", { 1, w.timer }));
+	CHECK(!Evaluate("entityType ~ \"ZTrigger*\"", { 1, ZEntityRef() }));
+}
+
+static auto TestData(TestWorld& w) -> void {
+	auto s_Float = 0.6f;
+	auto s_Int = int32(3);
+	const auto s_String = ZString("abc");
+
+	CHECK(Evaluate("data.float > 0.5", { 1, w.trigger, w.floatType, &s_Float }));
+	// Single precision values are compared against the literal rounded the same way.
+	CHECK(Evaluate("data == 0.6", { 1, w.trigger, w.floatType, &s_Float }));
+	CHECK(Evaluate("data.int == 3", { 1, w.trigger, w.intType, &s_Int }));
+	CHECK(!Evaluate("data.float == 3", { 1, w.trigger, w.intType, &s_Int }));
+	CHECK(Evaluate("data >= 3 && data < 4", { 1, w.trigger, w.intType, &s_Int }));
+	CHECK(Evaluate("data == \"abc\"", { 1, w.trigger, w.stringType, &s_String }));
+	CHECK(Evaluate("data.string ~ \"B\"", { 1, w.trigger, w.stringType, &s_String }));
+	CHECK(!Evaluate("data", { 1, w.trigger }));
+	CHECK(Evaluate("!data", { 1, w.trigger }));
+}
+
+static auto TestProperties(TestWorld& w) -> void {
+	CHECK(Evaluate("prop[\"m_bEnabled\"]", { 1, w.trigger }));
+	CHECK(!Evaluate("prop[\"m_bEnabled\"]", { 1, w.timer }));
+	CHECK(Evaluate("prop[\"m_bEnabled\"] == true", { 1, w.trigger }));
+	CHECK(Evaluate("prop[\"m_bEnabled\"] == false", { 1, w.timer }));
+	CHECK(Evaluate("prop[\"m_fValue\"] == 0.7", { 1, w.trigger }));
+	CHECK(Evaluate("prop[\"m_fValue\"].float >= 0.5", { 1, w.trigger }));
+	CHECK(!Evaluate("prop[\"m_fValue\"].int >= 0", { 1, w.trigger }));
+	CHECK(Evaluate("prop[\"m_sName\"] == \"hello\"", { 1, w.trigger }));
+	CHECK(Evaluate("prop[\"m_sName\"] ~ \"ELL\"", { 1, w.trigger }));
+	CHECK(!Evaluate("prop[\"m_sName\"] !~ \"ELL\"", { 1, w.trigger }));
+	CHECK(!Evaluate("prop[\"m_sName\"]", { 1, w.timer }));
+	CHECK(!Evaluate("prop[\"missing\"] == 0", { 1, w.trigger }));
+}
+
+static auto TestErrors() -> void {
+	CHECK(ErrorOf("pin == Foo") == "Unknown pin 'Foo' at column 8");
+	CHECK(ErrorOf("pin == 1.5") == "Pin IDs must be whole numbers at column 8");
+	CHECK(ErrorOf("pin == -1") == "Pin ID out of range at column 8");
+	CHECK(ErrorOf("pin == 0x100000000") == "Pin ID out of range at column 8");
+	CHECK(ErrorOf("pin < 3").starts_with("Pins can only be compared with == or !="));
+	CHECK(ErrorOf("entityType").starts_with("Entity types can only be compared"));
+	CHECK(ErrorOf("entityType ==").starts_with("Expected an entity type name"));
+	CHECK(ErrorOf("entityType < 3").starts_with("Entity types can only be compared"));
+	CHECK(ErrorOf("data ~ 3").starts_with("~ and !~ need a string in quotes"));
+	CHECK(ErrorOf("data.float == \"x\"").starts_with("Only strings can be compared with text"));
+	CHECK(ErrorOf("data.string == 1").starts_with("Strings can only be compared with text"));
+	CHECK(ErrorOf("data < \"x\"").starts_with("Only strings can be compared with text"));
+	CHECK(ErrorOf("data.double > 1").starts_with("Expected .bool, .int, .float or .string"));
+	CHECK(ErrorOf("data ~ \"re:(\"").starts_with("Invalid regular expression"));
+	CHECK(ErrorOf("prop[m] == 1").starts_with("Expected a property name in quotes"));
+	CHECK(ErrorOf("prop[\"m\" == 1").starts_with("Expected ']'"));
+	CHECK(ErrorOf("data == \"abc").starts_with("Unterminated string"));
+	CHECK(ErrorOf("(pin == 1").starts_with("Expected ')'"));
+	CHECK(ErrorOf("pin == 1 &&").starts_with("Expected pin, entityType, data or prop"));
+	CHECK(ErrorOf("foo == 1") == "Unknown operand 'foo' at column 1");
+	CHECK(ErrorOf("pin == 1 pin") == "Unexpected 'p' at column 10");
+}
+
+static auto TestCache(TestWorld& w) -> void {
+	const Trigger s_Enabled("prop[\"m_bEnabled\"] && entityType == ZTriggerEntity", &ResolvePin);
+	const Trigger s_Name("prop[\"m_sName\"] == \"hello\"", &ResolvePin);
+	const auto s_Type = TestWorld::TypeOf(w.trigger);
+	Trigger::Cache cache;
+
+	// One cache used with several triggers only keeps the results of the last.
+	CHECK(s_Enabled.Evaluate(cache, 1, w.trigger, s_Type, nullptr, nullptr));
+	CHECK(s_Name.Evaluate(cache, 1, w.trigger, s_Type, nullptr, nullptr));
+	CHECK(s_Enabled.Evaluate(cache, 1, w.trigger, s_Type, nullptr, nullptr));
+	CHECK(!s_Enabled.Evaluate(cache, 1, w.timer, TestWorld::TypeOf(w.timer), nullptr, nullptr));
+
+	// A property that wasn't in a table is looked for again once another table takes over its address.
+	auto& s_Table = *w.trigger->GetType()->m_pProperties01;
+	const auto s_End = s_Table.m_pEnd;
+	s_Table.m_pEnd = s_Table.m_pBegin + 2;
+	CHECK(!s_Name.Evaluate(cache, 1, w.trigger, s_Type, nullptr, nullptr));
+	s_Table.m_pEnd = s_End;
+	CHECK(s_Name.Evaluate(cache, 1, w.trigger, s_Type, nullptr, nullptr));
+
+	cache.Clear();
+	CHECK(s_Name.Evaluate(cache, 1, w.trigger, s_Type, nullptr, nullptr));
+}
+
+int main() {
+	TestWorld s_World;
+	TestPins(s_World);
+	TestPrecedence(s_World);
+	TestEntityTypes(s_World);
+	TestData(s_World);
+	TestProperties(s_World);
+	TestErrors();
+	TestCache(s_World);
+	return CHECK_RESULT();
+}
@@ -0,0 +1,100 @@
+#include "CaptureAnalysis.h"
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+auto CaptureAggregate::Add(const CaptureFormat::Record& record) -> void {
+	auto [pin, inserted] = pins.TryEmplace(record.pinId);
+
+	if (inserted) {
+		pin->pinName = record.pinName;
+		pin->firstTimestamp = record.timestamp;
+	}
+	else pin->interArrival.Add(record.timestamp - std::min(record.timestamp, pin->lastTimestamp));
+
+	pin->lastTimestamp = record.timestamp;
+	++pin->count;
+
+	++entityTypes[record.entityType];
+	++frames[record.frame];
+
+	if (records++ == 0)
+		firstTimestamp = record.timestamp;
+	lastTimestamp = record.timestamp;
+}
+
+auto CaptureAggregate::Merge(const CaptureAggregate& later) -> void {
+	if (later.records == 0) return;
+
+	later.pins.ForEach([this](const uint32_t& id, const PinAggregate& laterPin) {
+		auto [pin, inserted] = pins.TryEmplace(id);
+
+		if (inserted) {
+			*pin = laterPin;
+			return;
+		}
+
+		pin->interArrival.Add(laterPin.firstTimestamp - std::min(laterPin.firstTimestamp, pin->lastTimestamp));
+		pin->interArrival.Merge(laterPin.interArrival);
+		pin->count += laterPin.count;
+		pin->lastTimestamp = laterPin.lastTimestamp;
+		if (!pin->pinName) pin->pinName = laterPin.pinName;
+	});
+
+	later.entityTypes.ForEach([this](const uint32_t& type, const uint64_t& count) {
+		entityTypes[type] += count;
+	});
+
+	later.frames.ForEach([this](const uint32_t& frame, const uint64_t& count) {
+		frames[frame] += count;
+	});
+
+	if (records == 0)
+		firstTimestamp = later.firstTimestamp;
+	lastTimestamp = later.lastTimestamp;
+	records += later.records;
+}
+
+auto AnalyzeCapture(const CaptureReader& reader, unsigned threadCount) -> CaptureAggregate {
+	const auto& blocks = reader.GetRecordBlocks();
+	threadCount = std::clamp<unsigned>(threadCount, 1, static_cast<unsigned>(std::max<size_t>(blocks.size(), 1)));
+
+	// Balance the ranges by record count, blocks can differ a lot in size.
+	std::vector<size_t> rangeStarts{ 0 };
+	const auto perThread = reader.GetRecordCount() / threadCount + 1;
+	uint64_t inRange = 0;
+
+	for (size_t i = 0; i < blocks.size(); ++i) {
+		if (inRange >= perThread && rangeStarts.size() < threadCount) {
+			rangeStarts.push_back(i);
+			inRange = 0;
+		}
+		inRange += blocks[i].count;
+	}
+
+	rangeStarts.push_back(blocks.size());
+
+	std::vector<CaptureAggregate> partials(rangeStarts.size() - 1);
+	std::vector<std::thread> threads;
+
+	for (size_t range = 0; range < partials.size(); ++range) {
+		threads.emplace_back([&, range] {
+			auto& partial = partials[range];
+
+			for (auto i = rangeStarts[range]; i < rangeStarts[range + 1]; ++i) {
+				const auto& block = blocks[i];
+				for (uint32_t j = 0; j < block.count; ++j)
+					partial.Add(block.records[j]);
+			}
+		});
+	}
+
+	for (auto& thread : threads)
+		thread.join();
+
+	CaptureAggregate result;
+	for (auto& partial : partials)
+		result.Merge(partial);
+	result.threads = static_cast<unsigned>(std::max<size_t>(partials.size(), 1));
+	return result;
+}
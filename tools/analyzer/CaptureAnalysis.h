@@ -0,0 +1,72 @@
+#pragma once
+#include "CaptureReader.h"
+#include "FlatHashMap.h"
+#include <array>
+#include <bit>
+#include <cstdint>
+
+// Histogram with one bucket per power of two, bucket i holding values in [2^(i-1), 2^i).
+struct Log2Histogram {
+	std::array<uint64_t, 65> buckets{};
+	uint64_t count = 0;
+
+	auto Add(uint64_t value, uint64_t times = 1) -> void {
+		buckets[std::bit_width(value)] += times;
+		count += times;
+	}
+
+	auto Merge(const Log2Histogram& other) -> void {
+		for (size_t i = 0; i < buckets.size(); ++i)
+			buckets[i] += other.buckets[i];
+		count += other.count;
+	}
+
+	// Upper bound of the bucket holding the given quantile.
+	auto Quantile(double q) const -> uint64_t {
+		if (count == 0) return 0;
+
+		const auto target = static_cast<uint64_t>(q * static_cast<double>(count - 1));
+		uint64_t seen = 0;
+
+		for (size_t i = 0; i < buckets.size(); ++i) {
+			seen += buckets[i];
+			if (seen > target)
+				return i == 0 ? 0 : i >= 64 ? UINT64_MAX : (uint64_t(1) << i) - 1;
+		}
+
+		return UINT64_MAX;
+	}
+};
+
+struct PinAggregate {
+	uint32_t pinName = 0;
+	uint64_t count = 0;
+	uint64_t firstTimestamp = 0;
+	uint64_t lastTimestamp = 0;
+	// Nanoseconds between consecutive calls of the pin.
+	Log2Histogram interArrival;
+};
+
+// Statistics over a contiguous run of records. Partial results for consecutive runs are combined with
+// Merge, which also accounts for the gaps that span the boundary between them.
+struct CaptureAggregate {
+	FlatHashMap<uint32_t, PinAggregate> pins;
+	FlatHashMap<uint32_t, uint64_t> entityTypes;
+	FlatHashMap<uint32_t, uint64_t> frames;
+	uint64_t records = 0;
+	uint64_t firstTimestamp = 0;
+	uint64_t lastTimestamp = 0;
+	// Threads AnalyzeCapture actually split the records across.
+	unsigned threads = 1;
+
+	auto Add(const CaptureFormat::Record& record) -> void;
+	// `later` must cover the records immediately following the ones in this aggregate.
+	auto Merge(const CaptureAggregate& later) -> void;
+
+	auto Duration() const -> double {
+		return static_cast<double>(lastTimestamp - firstTimestamp) / 1e9;
+	}
+};
+
+// Splits the record blocks into one contiguous range per thread and merges the partial results in order.
+auto AnalyzeCapture(const CaptureReader& reader, unsigned threadCount) -> CaptureAggregate;
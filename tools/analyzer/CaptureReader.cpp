@@ -0,0 +1,154 @@
+#include "CaptureReader.h"
+#include <cstring>
+
+using namespace CaptureFormat;
+
+auto CaptureReader::Open(const std::filesystem::path& path) -> bool {
+	if (!file.Open(path)) {
+		error = file.GetError();
+		return false;
+	}
+
+	const auto base = file.Data();
+	auto end = file.Size();
+
+	if (end < sizeof(FileHeader) || std::memcmp(base, Magic, sizeof(Magic)) != 0) {
+		error = "not a pin capture file";
+		return false;
+	}
+
+	header = reinterpret_cast<const FileHeader*>(base);
+
+	if (header->version == 0 || header->version > Version) {
+		error = "unsupported capture version " + std::to_string(header->version);
+		return false;
+	}
+
+	const Footer* footer = nullptr;
+
+	if (end >= sizeof(FileHeader) + sizeof(Footer)) {
+		footer = reinterpret_cast<const Footer*>(base + end - sizeof(Footer));
+		if (std::memcmp(footer->magic, FooterMagic, sizeof(FooterMagic)) == 0) {
+			complete = true;
+			end -= sizeof(Footer);
+		}
+	}
+
+	indexed = complete && header->version >= FirstIndexedVersion && this->ReadIndexed(*footer, end);
+
+	if (!indexed) {
+		strings.clear();
+		recordBlocks.clear();
+		recordCount = 0;
+		this->ReadBlocks(end);
+	}
+
+	return true;
+}
+
+auto CaptureReader::BlockAt(size_t offset, size_t end) const -> const BlockHeader* {
+	if (offset < header->headerSize || offset % Alignment != 0 || offset > end || end - offset < sizeof(BlockHeader))
+		return nullptr;
+
+	const auto block = reinterpret_cast<const BlockHeader*>(file.Data() + offset);
+	return block->size <= end - offset - sizeof(BlockHeader) ? block : nullptr;
+}
+
+auto CaptureReader::ReadIndexed(const Footer& footer, size_t end) -> bool {
+	// The chain runs from the last index block back to the first, so it is collected before reading forwards.
+	std::vector<const BlockHeader*> indexBlocks;
+
+	for (auto offset = footer.lastIndexOffset; offset != 0;) {
+		const auto block = this->BlockAt(offset, end);
+		if (!block || block->type != BlockType::Index) return false;
+		if (sizeof(uint64_t) + static_cast<size_t>(block->count) * sizeof(IndexEntry) > block->size) return false;
+
+		uint64_t previous;
+		std::memcpy(&previous, block + 1, sizeof(previous));
+
+		// Every index block points further back than itself, which also rules out loops.
+		if (previous >= offset) return false;
+
+		indexBlocks.push_back(block);
+		offset = previous;
+	}
+
+	for (auto it = indexBlocks.rbegin(); it != indexBlocks.rend(); ++it) {
+		const auto entries = reinterpret_cast<const IndexEntry*>(reinterpret_cast<const std::byte*>(*it + 1) + sizeof(uint64_t));
+
+		for (uint32_t i = 0; i < (*it)->count; ++i) {
+			const auto& entry = entries[i];
+			auto offset = static_cast<size_t>(entry.blockOffset);
+			auto block = this->BlockAt(offset, end);
+
+			// Names first used by the block's records are written right before it.
+			if (block && block->type == BlockType::Strings) {
+				this->ReadStrings(reinterpret_cast<const std::byte*>(block + 1), *block);
+				offset += sizeof(BlockHeader) + block->size;
+				block = this->BlockAt(offset, end);
+			}
+
+			if (!block || block->type != BlockType::Records || block->count != entry.recordCount)
+				return false;
+			if (!this->ReadRecords(reinterpret_cast<const std::byte*>(block + 1), *block))
+				return false;
+		}
+	}
+
+	return recordCount == footer.recordCount;
+}
+
+auto CaptureReader::ReadBlocks(size_t end) -> void {
+	for (size_t offset = header->headerSize; offset + sizeof(BlockHeader) <= end;) {
+		const auto block = this->BlockAt(offset, end);
+
+		// A block cut short by a crash ends the capture.
+		if (!block) break;
+
+		const auto payload = reinterpret_cast<const std::byte*>(block + 1);
+
+		switch (block->type) {
+		case BlockType::Strings:
+			this->ReadStrings(payload, *block);
+			break;
+		case BlockType::Records:
+			this->ReadRecords(payload, *block);
+			break;
+		case BlockType::Index:
+			break;
+		}
+
+		offset += sizeof(BlockHeader) + block->size;
+	}
+}
+
+auto CaptureReader::ReadRecords(const std::byte* payload, const BlockHeader& block) -> bool {
+	const auto recordBytes = static_cast<size_t>(block.count) * sizeof(Record);
+	if (recordBytes > block.size) return false;
+
+	RecordBlock records;
+	records.records = reinterpret_cast<const Record*>(payload);
+	records.count = block.count;
+	records.data = reinterpret_cast<const char*>(payload + recordBytes);
+	records.dataSize = block.size - recordBytes;
+	recordBlocks.push_back(records);
+	recordCount += block.count;
+	return true;
+}
+
+auto CaptureReader::ReadStrings(const std::byte* payload, const BlockHeader& block) -> void {
+	size_t offset = 0;
+
+	for (uint32_t i = 0; i < block.count && offset + sizeof(StringEntry) <= block.size; ++i) {
+		const auto& entry = *reinterpret_cast<const StringEntry*>(payload + offset);
+		offset += sizeof(StringEntry);
+
+		if (entry.length > block.size - offset) break;
+
+		if (entry.symbol >= strings.size())
+			strings.resize(entry.symbol + 1);
+
+		strings[entry.symbol] = { reinterpret_cast<const char*>(payload + offset), entry.length };
+		offset += AlignUp(entry.length);
+	}
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include "CaptureFormat.h"
+#include "MappedFile.h"
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Memory-mapped view of a .pincap file. Opening a complete capture follows its index blocks back from the
+// footer, anything else is read by walking the block headers. Records are read in place.
+class CaptureReader {
+public:
+	struct RecordBlock {
+		const CaptureFormat::Record* records = nullptr;
+		uint32_t count = 0;
+		const char* data = nullptr;
+		size_t dataSize = 0;
+
+		auto GetData(const CaptureFormat::Record& record) const -> std::string_view {
+			if (static_cast<size_t>(record.dataOffset) + record.dataSize > dataSize) return {};
+			return { data + record.dataOffset, record.dataSize };
+		}
+	};
+
+	auto Open(const std::filesystem::path& path) -> bool;
+
+	auto GetString(uint32_t symbol) const -> std::string_view {
+		return symbol < strings.size() ? strings[symbol] : std::string_view();
+	}
+
+	auto GetHeader() const -> const CaptureFormat::FileHeader& { return *header; }
+	auto GetRecordBlocks() const -> const std::vector<RecordBlock>& { return recordBlocks; }
+	auto GetRecordCount() const -> uint64_t { return recordCount; }
+	auto GetFileSize() const -> size_t { return file.Size(); }
+	// False if the capture wasn't closed cleanly, in which case everything up to the last whole block is read.
+	auto IsComplete() const -> bool { return complete; }
+	// True if the blocks were found through the index rather than by walking the file.
+	auto IsIndexed() const -> bool { return indexed; }
+	auto GetError() const -> const std::string& { return error; }
+
+private:
+	// The block at `offset` if both it and its payload lie before `end`.
+	auto BlockAt(size_t offset, size_t end) const -> const CaptureFormat::BlockHeader*;
+	// Returns false if the index doesn't hold together, leaving the caller to fall back to ReadBlocks.
+	auto ReadIndexed(const CaptureFormat::Footer& footer, size_t end) -> bool;
+	auto ReadBlocks(size_t end) -> void;
+	auto ReadStrings(const std::byte* payload, const CaptureFormat::BlockHeader& block) -> void;
+	auto ReadRecords(const std::byte* payload, const CaptureFormat::BlockHeader& block) -> bool;
+
+	MappedFile file;
+	const CaptureFormat::FileHeader* header = nullptr;
+	std::vector<std::string_view> strings;
+	std::vector<RecordBlock> recordBlocks;
+	uint64_t recordCount = 0;
+	bool complete = false;
+	bool indexed = false;
+	std::string error;
+};
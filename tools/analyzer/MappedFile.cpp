@@ -0,0 +1,93 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#else
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+auto MappedFile::Open(const std::filesystem::path& path) -> bool {
+	this->Close();
+
+#ifdef _WIN32
+	fileHandle = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (fileHandle == INVALID_HANDLE_VALUE) {
+		fileHandle = nullptr;
+		error = "could not open file";
+		return false;
+	}
+
+	LARGE_INTEGER fileSize{};
+	GetFileSizeEx(fileHandle, &fileSize);
+	size = static_cast<size_t>(fileSize.QuadPart);
+	if (size == 0) return true;
+
+	mappingHandle = CreateFileMappingW(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!mappingHandle) {
+		error = "could not create file mapping";
+		this->Close();
+		return false;
+	}
+
+	data = static_cast<const std::byte*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+	if (!data) {
+		error = "could not map file";
+		this->Close();
+		return false;
+	}
+#else
+	const auto fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0) {
+		error = std::strerror(errno);
+		return false;
+	}
+
+	struct stat info {};
+	if (::fstat(fd, &info) != 0) {
+		error = std::strerror(errno);
+		::close(fd);
+		return false;
+	}
+
+	size = static_cast<size_t>(info.st_size);
+
+	if (size > 0) {
+		auto mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (mapping == MAP_FAILED) {
+			error = std::strerror(errno);
+			size = 0;
+			::close(fd);
+			return false;
+		}
+
+		data = static_cast<const std::byte*>(mapping);
+	}
+
+	// The mapping stays valid after the descriptor is closed.
+	::close(fd);
+#endif
+
+	return true;
+}
+
+auto MappedFile::Close() -> void {
+#ifdef _WIN32
+	if (data) UnmapViewOfFile(data);
+	if (mappingHandle) CloseHandle(mappingHandle);
+	if (fileHandle) CloseHandle(fileHandle);
+	mappingHandle = nullptr;
+	fileHandle = nullptr;
+#else
+	if (data) ::munmap(const_cast<std::byte*>(data), size);
+#endif
+
+	data = nullptr;
+	size = 0;
+}
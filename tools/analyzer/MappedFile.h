@@ -0,0 +1,32 @@
+#pragma once
+#include <cstddef>
+#include <filesystem>
+#include <string>
+
+// Read-only memory mapping of a whole file.
+class MappedFile {
+public:
+	MappedFile() = default;
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	~MappedFile() {
+		this->Close();
+	}
+
+	auto Open(const std::filesystem::path& path) -> bool;
+	auto Close() -> void;
+
+	auto Data() const -> const std::byte* { return data; }
+	auto Size() const -> size_t { return size; }
+	auto GetError() const -> const std::string& { return error; }
+
+private:
+	const std::byte* data = nullptr;
+	size_t size = 0;
+	std::string error;
+#ifdef _WIN32
+	void* fileHandle = nullptr;
+	void* mappingHandle = nullptr;
+#endif
+};
@@ -0,0 +1,150 @@
+#include "CaptureAnalysis.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+static auto PrintUsage() -> void {
+	std::puts("Usage: PinCushionAnalyzer <capture.pincap> [--top N] [--threads N]");
+}
+
+static auto FormatNanoseconds(uint64_t ns) -> std::string {
+	char buffer[32];
+
+	if (ns == UINT64_MAX) return "inf";
+	if (ns < 1000) std::snprintf(buffer, sizeof(buffer), "%llu ns", static_cast<unsigned long long>(ns));
+	else if (ns < 1000000) std::snprintf(buffer, sizeof(buffer), "%.1f us", ns / 1e3);
+	else if (ns < 1000000000) std::snprintf(buffer, sizeof(buffer), "%.1f ms", ns / 1e6);
+	else std::snprintf(buffer, sizeof(buffer), "%.2f s", ns / 1e9);
+
+	return buffer;
+}
+
+static auto SymbolName(const CaptureReader& reader, uint32_t symbol) -> std::string_view {
+	const auto name = reader.GetString(symbol);
+	return name.empty() ? std::string_view("(none)") : name;
+}
+
+template <typename K, typename V, typename Less>
+static auto SortedTop(const FlatHashMap<K, V>& map, size_t count, Less&& less) -> std::vector<std::pair<K, const V*>> {
+	std::vector<std::pair<K, const V*>> entries;
+	entries.reserve(map.Size());
+	map.ForEach([&](const K& key, const V& value) { entries.emplace_back(key, &value); });
+
+	count = std::min(count, entries.size());
+	std::partial_sort(entries.begin(), entries.begin() + count, entries.end(), [&](auto& a, auto& b) { return less(*b.second, *a.second); });
+	entries.resize(count);
+	return entries;
+}
+
+static auto PrintPins(const CaptureReader& reader, const CaptureAggregate& result, size_t top) -> void {
+	const auto duration = std::max(result.Duration(), 1e-9);
+	const auto pins = SortedTop(result.pins, top, [](const PinAggregate& a, const PinAggregate& b) { return a.count < b.count; });
+
+	std::printf("\nTop %zu pins by calls\n", pins.size());
+	std::printf("%12s %10s %7s %10s %10s %10s  %s\n", "calls", "per sec", "share", "gap p50", "gap p90", "gap p99", "pin");
+
+	for (auto& [id, pin] : pins) {
+		const auto name = SymbolName(reader, pin->pinName);
+		std::printf("%12llu %10.1f %6.2f%% %10s %10s %10s  %.*s (%u)\n",
+			static_cast<unsigned long long>(pin->count),
+			pin->count / duration,
+			100.0 * pin->count / result.records,
+			FormatNanoseconds(pin->interArrival.Quantile(.5)).c_str(),
+			FormatNanoseconds(pin->interArrival.Quantile(.9)).c_str(),
+			FormatNanoseconds(pin->interArrival.Quantile(.99)).c_str(),
+			static_cast<int>(name.size()), name.data(), id);
+	}
+}
+
+static auto PrintEntityTypes(const CaptureReader& reader, const CaptureAggregate& result, size_t top) -> void {
+	const auto duration = std::max(result.Duration(), 1e-9);
+	const auto types = SortedTop(result.entityTypes, top, [](uint64_t a, uint64_t b) { return a < b; });
+
+	std::printf("\nTop %zu entity types by firing rate\n", types.size());
+	std::printf("%12s %10s  %s\n", "calls", "per sec", "entity type");
+
+	for (auto& [type, count] : types) {
+		const auto name = SymbolName(reader, type);
+		std::printf("%12llu %10.1f  %.*s\n", static_cast<unsigned long long>(*count), *count / duration, static_cast<int>(name.size()), name.data());
+	}
+}
+
+static auto PrintFrames(const CaptureAggregate& result) -> void {
+	if (result.frames.Empty()) return;
+
+	Log2Histogram perFrame;
+	uint32_t busiestFrame = 0;
+	uint64_t busiestCount = 0;
+
+	result.frames.ForEach([&](const uint32_t& frame, const uint64_t& count) {
+		perFrame.Add(count);
+		if (count > busiestCount) {
+			busiestCount = count;
+			busiestFrame = frame;
+		}
+	});
+
+	std::printf("\nEvents per frame over %zu frames with events: mean %.1f, max %llu (frame %u)\n",
+		result.frames.Size(), static_cast<double>(result.records) / result.frames.Size(),
+		static_cast<unsigned long long>(busiestCount), busiestFrame);
+
+	for (size_t i = 1; i < perFrame.buckets.size(); ++i) {
+		if (!perFrame.buckets[i]) continue;
+
+		const auto low = uint64_t(1) << (i - 1);
+		const auto high = (uint64_t(1) << i) - 1;
+		const auto width = static_cast<int>(50.0 * perFrame.buckets[i] / perFrame.count + .5);
+		std::printf("%8llu-%-8llu %10llu  %s\n",
+			static_cast<unsigned long long>(low), static_cast<unsigned long long>(high),
+			static_cast<unsigned long long>(perFrame.buckets[i]), std::string(width, '#').c_str());
+	}
+}
+
+int main(int argc, char* argv[]) {
+	const char* path = nullptr;
+	size_t top = 20;
+	unsigned threads = std::max(std::thread::hardware_concurrency(), 1u);
+
+	for (int i = 1; i < argc; ++i) {
+		if (std::strcmp(argv[i], "--top") == 0 && i + 1 < argc)
+			top = std::strtoul(argv[++i], nullptr, 10);
+		else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+			threads = std::strtoul(argv[++i], nullptr, 10);
+		else if (argv[i][0] == '-') {
+			PrintUsage();
+			return argv[i][1] == 'h' || std::strcmp(argv[i], "--help") == 0 ? 0 : 1;
+		}
+		else path = argv[i];
+	}
+
+	if (!path) {
+		PrintUsage();
+		return 1;
+	}
+
+	CaptureReader reader;
+
+	if (!reader.Open(path)) {
+		std::fprintf(stderr, "%s: %s\n", path, reader.GetError().c_str());
+		return 1;
+	}
+
+	const auto start = std::chrono::steady_clock::now();
+	const auto result = AnalyzeCapture(reader, threads);
+	const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	std::printf("%s: %llu records, %.1f MiB, %.2f s of capture%s\n", path,
+		static_cast<unsigned long long>(result.records), reader.GetFileSize() / (1024.0 * 1024.0), result.Duration(),
+		reader.IsComplete() ? "" : " (not closed cleanly)");
+	std::printf("Analyzed %zu blocks on %u threads in %.3f s\n", reader.GetRecordBlocks().size(), result.threads, elapsed);
+
+	PrintPins(reader, result, top);
+	PrintEntityTypes(reader, result, top);
+	PrintFrames(result);
+	return 0;
+}